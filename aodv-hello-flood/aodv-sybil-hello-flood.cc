@@ -0,0 +1,142 @@
+#include <iostream>
+#include "ns3/aodv-module.h"
+#include "ns3/fsm.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvSybilHelloFlood");
+
+static uint64_t g_hellos = 0;
+
+// Counts HELLOs among the IP packets the attacker sends: broadcast RREPs on the AODV port
+void CountHello(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface) {
+  Ptr<Packet> copy = packet->Copy ();
+  Ipv4Header ipHeader;
+  copy->RemoveHeader (ipHeader);
+  Ipv4Address destination = ipHeader.GetDestination ();
+  if (ipHeader.GetProtocol () != UdpL4Protocol::PROT_NUMBER
+      || (destination != ipv4->GetAddress (interface, 0).GetBroadcast () && !destination.IsBroadcast ())) {
+    return;
+  }
+  UdpHeader udpHeader;
+  copy->RemoveHeader (udpHeader);
+  aodv::TypeHeader typeHeader;
+  copy->PeekHeader (typeHeader);
+  if (udpHeader.GetDestinationPort () == aodv::RoutingProtocol::AODV_PORT && typeHeader.IsValid () && typeHeader.Get () == aodv::AODVTYPE_RREP) {
+    g_hellos++;
+  }
+}
+
+// Prints one point of the state growth curve
+void Sample(NodeContainer nodes, Time interval) {
+  uint64_t routes = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i) {
+    routes += nodes.Get (i)->GetObject<aodv::RoutingProtocol> ()->GetRoutingTableSize ();
+  }
+  // Lower bound: hash node of an unordered_map holds the key, the Fsm and a next pointer
+  uint64_t fsmBytes = aodv::Fsms::GetSize () * (sizeof (Ipv4Address) + sizeof (aodv::Fsm) + sizeof (void *));
+  std::cout << Simulator::Now ().GetSeconds () << "\t" << g_hellos << "\t" << aodv::Fsms::GetSize ()
+            << "\t" << aodv::Fsms::GetBlockedSize () << "\t" << fsmBytes << "\t" << routes << "\n";
+  Simulator::Schedule (interval, &Sample, nodes, interval);
+}
+
+int main(int argc, char** argv) {
+  uint32_t gridWidth = 3;
+  uint32_t identities = 256;
+  double helloInterval = 1;
+  double duration = 10;
+  double sampleInterval = 1;
+  bool prevention = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("gridWidth", "Number of honest nodes in a grid row (grid is gridWidth x gridWidth)", gridWidth);
+  cmd.AddValue ("identities", "Spoofed identities the attacker rotates through, 1 for a plain hello flood", identities);
+  cmd.AddValue ("helloInterval", "Interval between flooded HELLO messages, ms", helloInterval);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.AddValue ("sampleInterval", "Interval between state samples, s", sampleInterval);
+  cmd.AddValue ("prevention", "Enable hello flood prevention on honest nodes", prevention);
+  cmd.Parse (argc, argv);
+
+  SeedManager::SetSeed(12345);
+
+  uint32_t nodesQuantity = gridWidth * gridWidth;
+  NodeContainer nodes;
+  nodes.Create (nodesQuantity);
+  NodeContainer attacker;
+  attacker.Create (1);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (50),
+                                 "DeltaY", DoubleValue (50),
+                                 "GridWidth", UintegerValue(gridWidth),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  mobility.Install (attacker);
+  // Attacker in the middle of the grid; at 50 m spacing it reaches every honest node only up to gridWidth 3
+  double middle = (gridWidth - 1) * 50 / 2.0;
+  attacker.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (middle, middle, 0));
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  NetDeviceContainer attackerDevice = wifi.Install (wifiPhy, wifiMac, attacker);
+
+  AodvHelper aodv;
+  aodv.Set ("EnableHelloFloodPrevention", BooleanValue (prevention));
+
+  std::ostringstream behavior;
+  behavior << "ns3::aodv::SybilHelloFloodAttack[Interval=" << helloInterval << "ms|Identities=" << identities << "]";
+  AodvHelper aodvSybil;
+  aodvSybil.Set ("AttackBehavior", StringValue (behavior.str ()));
+  aodvSybil.Set ("EnableHello", BooleanValue (true));
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+
+  InternetStackHelper attackerStack;
+  attackerStack.SetRoutingHelper (aodvSybil);
+  attackerStack.Install (attacker);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  address.Assign (devices);
+  address.Assign (attackerDevice);
+
+  attacker.Get (0)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&CountHello));
+
+  std::cout << "Identities: " << identities << ", honest nodes: " << nodesQuantity
+            << ", Fsm size: " << sizeof (aodv::Fsm) << " B\n";
+  std::cout << "time\thellos\tfsms\tblocked\tfsmBytes\troutes\n";
+  Simulator::Schedule (Seconds (sampleInterval), &Sample, nodes, Seconds (sampleInterval));
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+
+  std::cout << "Flooded HELLOs: " << g_hellos << "\n";
+  std::cout << "Wall clock: " << elapsedMs << " ms\n";
+  if (g_hellos > 0) {
+    std::cout << "Wall clock per flooded HELLO: " << elapsedMs * 1000.0 / g_hellos << " us\n";
+  }
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -0,0 +1,547 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-attack-behavior.h"
+#include "aodv-routing-protocol.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvAttackBehavior");
+
+namespace aodv {
+
+NS_OBJECT_ENSURE_REGISTERED (AttackBehavior);
+
+TypeId
+AttackBehavior::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::AttackBehavior")
+    .SetParent<Object> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<AttackBehavior> ()
+  ;
+  return tid;
+}
+
+AttackBehavior::AttackBehavior ()
+{
+}
+
+AttackBehavior::~AttackBehavior ()
+{
+}
+
+bool
+AttackBehavior::OnRreqReceived (RreqHeader const & rreq, Ipv4Address src)
+{
+  return false;
+}
+
+void
+AttackBehavior::OnRrepBuild (RrepHeader & rrep)
+{
+}
+
+bool
+AttackBehavior::OnForward (Ptr<const Packet> p, Ipv4Header const & header)
+{
+  return true;
+}
+
+Ptr<Ipv4Route>
+AttackBehavior::OnRouteOutput (Ipv4Header const & header, Ptr<Ipv4Route> route)
+{
+  return route;
+}
+
+Time
+AttackBehavior::OnHelloSchedule (Time interval)
+{
+  return interval;
+}
+
+Ipv4Address
+AttackBehavior::OnHelloOrigin (Ipv4Address origin)
+{
+  return origin;
+}
+
+bool
+AttackBehavior::OnControlSend (Ptr<const Packet> packet, Ipv4Address destination)
+{
+  return false;
+}
+
+bool
+AttackBehavior::OnDataSend (Ptr<const Packet> p, Ipv4Header const & header, Ipv4Address nextHop)
+{
+  return false;
+}
+
+bool
+AttackBehavior::OnOriginate (Ipv4Address nextHop)
+{
+  return false;
+}
+
+Time
+AttackBehavior::OnRreqFloodSchedule ()
+{
+  return Seconds (0);
+}
+
+Ipv4Address
+AttackBehavior::OnRreqFloodDestination ()
+{
+  return Ipv4Address::GetAny ();
+}
+
+void
+AttackBehavior::OnActivate ()
+{
+}
+
+int64_t
+AttackBehavior::AssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (BlackHoleAttack);
+
+TypeId
+BlackHoleAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::BlackHoleAttack")
+    .SetParent<AttackBehavior> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<BlackHoleAttack> ()
+    .AddAttribute ("SeqNoIncrement", "Added to the requested destination sequence number in forged RREPs.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&BlackHoleAttack::m_seqNoIncrement),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+BlackHoleAttack::BlackHoleAttack ()
+  : m_seqNoIncrement (100)
+{
+}
+
+bool
+BlackHoleAttack::OnRreqReceived (RreqHeader const & rreq, Ipv4Address src)
+{
+  NS_LOG_LOGIC ("Answer RREQ for " << rreq.GetDst () << " from " << src << " with a forged route");
+  return true;
+}
+
+void
+BlackHoleAttack::OnRrepBuild (RrepHeader & rrep)
+{
+  rrep.SetHopCount (1);
+  rrep.SetDstSeqno (rrep.GetDstSeqno () + m_seqNoIncrement);
+}
+
+bool
+BlackHoleAttack::OnForward (Ptr<const Packet> p, Ipv4Header const & header)
+{
+  NS_LOG_LOGIC ("Drop packet " << p->GetUid () << " to " << header.GetDestination ());
+  return false;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (GrayHoleAttack);
+
+TypeId
+GrayHoleAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::GrayHoleAttack")
+    .SetParent<BlackHoleAttack> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<GrayHoleAttack> ()
+    .AddAttribute ("DropProbability", "Probability to drop a packet of the targeted flow in the on phase.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&GrayHoleAttack::m_dropProbability),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("TargetSource", "Source address of the targeted flow, 0.0.0.0 targets any source.",
+                   Ipv4AddressValue (Ipv4Address::GetAny ()),
+                   MakeIpv4AddressAccessor (&GrayHoleAttack::m_targetSource),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("TargetDestination", "Destination address of the targeted flow, 0.0.0.0 targets any destination.",
+                   Ipv4AddressValue (Ipv4Address::GetAny ()),
+                   MakeIpv4AddressAccessor (&GrayHoleAttack::m_targetDestination),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("OnTime", "Duration of the on phase of the duty cycle.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&GrayHoleAttack::m_onTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("OffTime", "Duration of the off phase of the duty cycle, 0 keeps the attack on.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&GrayHoleAttack::m_offTime),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+GrayHoleAttack::GrayHoleAttack ()
+  : m_dropProbability (0.5),
+    m_onTime (Seconds (1)),
+    m_offTime (Seconds (0)),
+    m_activated (Seconds (0))
+{
+  m_dropRv = CreateObject<UniformRandomVariable> ();
+}
+
+bool
+GrayHoleAttack::IsTargeted (Ipv4Header const & header) const
+{
+  return (m_targetSource == Ipv4Address::GetAny () || m_targetSource == header.GetSource ())
+         && (m_targetDestination == Ipv4Address::GetAny () || m_targetDestination == header.GetDestination ());
+}
+
+bool
+GrayHoleAttack::IsOn () const
+{
+  if (m_offTime.IsZero ())
+    {
+      return true;
+    }
+  int64_t period = (m_onTime + m_offTime).GetInteger ();
+  return (Simulator::Now () - m_activated).GetInteger () % period < m_onTime.GetInteger ();
+}
+
+void
+GrayHoleAttack::OnActivate ()
+{
+  m_activated = Simulator::Now ();
+}
+
+bool
+GrayHoleAttack::OnForward (Ptr<const Packet> p, Ipv4Header const & header)
+{
+  // Only targeted packets in the on phase draw a decision, so other traffic does not shift the stream
+  if (!IsTargeted (header) || !IsOn () || m_dropRv->GetValue () >= m_dropProbability)
+    {
+      return true;
+    }
+  NS_LOG_LOGIC ("Drop packet " << p->GetUid () << " to " << header.GetDestination ());
+  return false;
+}
+
+int64_t
+GrayHoleAttack::AssignStreams (int64_t stream)
+{
+  m_dropRv->SetStream (stream);
+  return 1;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (HelloFloodAttack);
+
+TypeId
+HelloFloodAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::HelloFloodAttack")
+    .SetParent<AttackBehavior> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<HelloFloodAttack> ()
+    .AddAttribute ("Interval", "Interval between flooded HELLO messages.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&HelloFloodAttack::m_interval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+HelloFloodAttack::HelloFloodAttack ()
+  : m_interval (MilliSeconds (1))
+{
+}
+
+Time
+HelloFloodAttack::OnHelloSchedule (Time interval)
+{
+  return m_interval;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (SybilHelloFloodAttack);
+
+TypeId
+SybilHelloFloodAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::SybilHelloFloodAttack")
+    .SetParent<HelloFloodAttack> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<SybilHelloFloodAttack> ()
+    .AddAttribute ("FirstIdentity", "First spoofed HELLO origin, the others follow it.",
+                   Ipv4AddressValue (Ipv4Address ("10.200.0.1")),
+                   MakeIpv4AddressAccessor (&SybilHelloFloodAttack::m_firstIdentity),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("Identities", "Number of spoofed HELLO origins to rotate through.",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&SybilHelloFloodAttack::m_identities),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+SybilHelloFloodAttack::SybilHelloFloodAttack ()
+  : m_firstIdentity (Ipv4Address ("10.200.0.1")),
+    m_identities (256),
+    m_next (0)
+{
+}
+
+Ipv4Address
+SybilHelloFloodAttack::OnHelloOrigin (Ipv4Address origin)
+{
+  Ipv4Address identity (m_firstIdentity.Get () + m_next);
+  m_next = (m_next + 1) % m_identities;
+  return identity;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (RreqFloodAttack);
+
+TypeId
+RreqFloodAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::RreqFloodAttack")
+    .SetParent<AttackBehavior> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<RreqFloodAttack> ()
+    .AddAttribute ("Interval", "Interval between flooded RREQs.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&RreqFloodAttack::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("FirstDestination", "First of the nonexistent destinations to search for.",
+                   Ipv4AddressValue (Ipv4Address ("10.128.0.1")),
+                   MakeIpv4AddressAccessor (&RreqFloodAttack::m_firstDestination),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("Destinations", "Number of nonexistent destinations to search for.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&RreqFloodAttack::m_destinations),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+RreqFloodAttack::RreqFloodAttack ()
+  : m_interval (MilliSeconds (10)),
+    m_firstDestination (Ipv4Address ("10.128.0.1")),
+    m_destinations (65536)
+{
+  m_destinationRv = CreateObject<UniformRandomVariable> ();
+}
+
+Time
+RreqFloodAttack::OnRreqFloodSchedule ()
+{
+  return m_interval;
+}
+
+Ipv4Address
+RreqFloodAttack::OnRreqFloodDestination ()
+{
+  return Ipv4Address (m_firstDestination.Get () + m_destinationRv->GetInteger (0, m_destinations - 1));
+}
+
+int64_t
+RreqFloodAttack::AssignStreams (int64_t stream)
+{
+  m_destinationRv->SetStream (stream);
+  return 1;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (WormholeAttack);
+
+TypeId
+WormholeAttack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::WormholeAttack")
+    .SetParent<AttackBehavior> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<WormholeAttack> ()
+    .AddAttribute ("Latency", "Delay of packets sent into the tunnel.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&WormholeAttack::m_latency),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+WormholeAttack::WormholeAttack ()
+  : m_latency (MilliSeconds (1)),
+    m_protocol (0),
+    m_tunneledControl (0),
+    m_tunneledData (0)
+{
+}
+
+void
+WormholeAttack::DoDispose (void)
+{
+  m_protocol = 0;
+  m_peer = 0;
+  AttackBehavior::DoDispose ();
+}
+
+void
+WormholeAttack::Connect (Ptr<RoutingProtocol> a, Ptr<RoutingProtocol> b)
+{
+  Ptr<WormholeAttack> endA = DynamicCast<WormholeAttack> (a->GetAttackBehavior ());
+  if (endA == 0)
+    {
+      endA = CreateObject<WormholeAttack> ();
+      a->SetAttackBehavior (endA);
+    }
+  Ptr<WormholeAttack> endB = DynamicCast<WormholeAttack> (b->GetAttackBehavior ());
+  if (endB == 0)
+    {
+      endB = CreateObject<WormholeAttack> ();
+      b->SetAttackBehavior (endB);
+    }
+  endA->Attach (a, endB);
+  endB->Attach (b, endA);
+}
+
+void
+WormholeAttack::Attach (Ptr<RoutingProtocol> protocol, Ptr<WormholeAttack> peer)
+{
+  Ptr<Ipv4> ipv4 = protocol->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4 != 0 && ipv4->GetNInterfaces () > 1, "Wormhole end needs an assigned address");
+  // Interface 0 is the loopback
+  Ipv4InterfaceAddress iface = ipv4->GetAddress (1, 0);
+  m_protocol = PeekPointer (protocol);
+  m_peer = peer;
+  m_address = iface.GetLocal ();
+  m_broadcast = iface.GetBroadcast ();
+}
+
+bool
+WormholeAttack::OnControlSend (Ptr<const Packet> packet, Ipv4Address destination)
+{
+  if (m_peer == 0)
+    {
+      return false;
+    }
+  bool toPeer = destination == m_peer->m_address;
+  if (!toPeer && !destination.IsBroadcast () && destination != m_broadcast)
+    {
+      return false;
+    }
+  // Packets tunneled back by the other end are dropped there as duplicates
+  ++m_tunneledControl;
+  Simulator::Schedule (m_latency, &WormholeAttack::RecvControl, m_peer, packet->Copy (), m_address);
+  return toPeer;
+}
+
+bool
+WormholeAttack::OnDataSend (Ptr<const Packet> p, Ipv4Header const & header, Ipv4Address nextHop)
+{
+  if (m_peer == 0 || nextHop != m_peer->m_address)
+    {
+      return false;
+    }
+  ++m_tunneledData;
+  Simulator::Schedule (m_latency, &WormholeAttack::RecvData, m_peer, p->Copy (), header);
+  return true;
+}
+
+bool
+WormholeAttack::OnOriginate (Ipv4Address nextHop)
+{
+  return m_peer != 0 && nextHop == m_peer->m_address;
+}
+
+void
+WormholeAttack::RecvControl (Ptr<Packet> packet, Ipv4Address sender)
+{
+  if (m_protocol != 0)
+    {
+      m_protocol->RecvTunneled (packet, sender);
+    }
+}
+
+void
+WormholeAttack::RecvData (Ptr<Packet> p, Ipv4Header header)
+{
+  if (m_protocol != 0)
+    {
+      m_protocol->ForwardTunneled (p, header);
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED (TrafficRedirection);
+
+TypeId
+TrafficRedirection::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::aodv::TrafficRedirection")
+    .SetParent<AttackBehavior> ()
+    .SetGroupName ("Aodv")
+    .AddConstructor<TrafficRedirection> ()
+    .AddAttribute ("Suspect", "Next hop watched by the FSM.",
+                   Ipv4AddressValue (Ipv4Address ("10.0.0.2")),
+                   MakeIpv4AddressAccessor (&TrafficRedirection::m_suspect),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("Tolerance", "Number of times the suspect is used as next hop before it is blacklisted.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&TrafficRedirection::m_tolerance),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ListTimeout", "Time the suspect stays blacklisted, 0 keeps it forever.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TrafficRedirection::m_listTimeout),
+                   MakeTimeChecker ())
+    .AddAttribute ("RedirectTo", "Next hop used instead of an illegal one.",
+                   Ipv4AddressValue (Ipv4Address ("10.0.0.3")),
+                   MakeIpv4AddressAccessor (&TrafficRedirection::m_redirectTo),
+                   MakeIpv4AddressChecker ())
+  ;
+  return tid;
+}
+
+TrafficRedirection::TrafficRedirection ()
+  : m_suspect (Ipv4Address ("10.0.0.2")),
+    m_tolerance (2),
+    m_listTimeout (Seconds (0)),
+    m_redirectTo (Ipv4Address ("10.0.0.3"))
+{
+}
+
+void
+TrafficRedirection::NotifyConstructionCompleted (void)
+{
+  m_fsm.Watch (m_suspect, m_tolerance, m_listTimeout);
+  AttackBehavior::NotifyConstructionCompleted ();
+}
+
+Ptr<Ipv4Route>
+TrafficRedirection::OnRouteOutput (Ipv4Header const & header, Ptr<Ipv4Route> route)
+{
+  if (m_fsm.IsNextHopLegal (route->GetGateway ()))
+    {
+      return route;
+    }
+  NS_LOG_DEBUG ("Redirect packet to " << route->GetDestination () << " via " << m_redirectTo);
+  m_policy.Blacklist (route->GetGateway (), m_redirectTo);
+  return m_policy.Apply (route);
+}
+
+}  // namespace aodv
+}  // namespace ns3
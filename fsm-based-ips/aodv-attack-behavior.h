@@ -0,0 +1,422 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_ATTACK_BEHAVIOR_H
+#define AODV_ATTACK_BEHAVIOR_H
+
+#include "aodv-packet.h"
+#include "aodv-route-policy.h"
+#include "experimental-finite-state-machine.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+namespace aodv {
+
+class RoutingProtocol;
+
+/**
+ * \ingroup aodv
+ * \brief Behavior of a routing protocol instance at its attack points.
+ *
+ * The routing protocol calls the hooks at the points where the attacks
+ * studied here deviate from AODV. This base class is the honest node: every
+ * hook keeps the protocol behavior unchanged. Attacks derive from it and
+ * are selected per node with the "AttackBehavior" attribute of
+ * RoutingProtocol, so honest and malicious nodes run the same build.
+ */
+class AttackBehavior : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AttackBehavior ();
+  virtual ~AttackBehavior ();
+
+  /**
+   * Called for a RREQ this node is not the destination of, before it
+   * looks for a route to the destination.
+   * \param rreq the RREQ header, hop count already incremented
+   * \param src the neighbor the RREQ came from
+   * \returns true to answer the RREQ with a RREP for a forged one hop
+   * route to the destination
+   */
+  virtual bool OnRreqReceived (RreqHeader const & rreq, Ipv4Address src);
+  /**
+   * Called for every RREP sent by this node as an intermediate node.
+   * \param rrep the RREP header to adjust
+   */
+  virtual void OnRrepBuild (RrepHeader & rrep);
+  /**
+   * Called for every data packet this node has to forward, before the
+   * route lookup.
+   * \param p the packet
+   * \param header the IP header
+   * \returns false to drop the packet silently
+   */
+  virtual bool OnForward (Ptr<const Packet> p, Ipv4Header const & header);
+  /**
+   * Called for every packet this node originates along a valid route.
+   * \param header the IP header
+   * \param route the route from the routing table, must not be modified
+   * \returns the route to send the packet along
+   */
+  virtual Ptr<Ipv4Route> OnRouteOutput (Ipv4Header const & header, Ptr<Ipv4Route> route);
+  /**
+   * Called every time the next HELLO is scheduled.
+   * \param interval the configured hello interval
+   * \returns the time until the next HELLO
+   */
+  virtual Time OnHelloSchedule (Time interval);
+  /**
+   * Called for every HELLO this node sends.
+   * \param origin the address of the interface the HELLO is sent from
+   * \returns the address the HELLO announces as its origin
+   */
+  virtual Ipv4Address OnHelloOrigin (Ipv4Address origin);
+  /**
+   * Called for every control packet this node sends.
+   * \param packet the packet, starting with the type header
+   * \param destination the neighbor or broadcast address it is sent to
+   * \returns true if the behavior has taken the packet, so it is not sent
+   */
+  virtual bool OnControlSend (Ptr<const Packet> packet, Ipv4Address destination);
+  /**
+   * Called for every data packet this node forwards, after the route lookup.
+   * \param p the packet
+   * \param header the IP header
+   * \param nextHop the next hop of the route
+   * \returns true if the behavior has taken the packet, so it is not sent
+   */
+  virtual bool OnDataSend (Ptr<const Packet> p, Ipv4Header const & header, Ipv4Address nextHop);
+  /**
+   * Called for every packet this node originates along a valid route,
+   * before its headers are complete.
+   * \param nextHop the next hop of the route
+   * \returns true to loop the packet back, so that OnDataSend gets it
+   * once its headers are complete
+   */
+  virtual bool OnOriginate (Ipv4Address nextHop);
+  /**
+   * Called when the behavior takes effect and after every flooded RREQ.
+   * \returns the time until the next flooded RREQ, 0 to flood none
+   */
+  virtual Time OnRreqFloodSchedule ();
+  /**
+   * Called for every flooded RREQ.
+   * \returns the destination to search a route for
+   */
+  virtual Ipv4Address OnRreqFloodDestination ();
+  /**
+   * Called every time the attack is switched on and when the behavior
+   * replaces another one of an active attacker. A behavior active from
+   * the start is not called; it takes effect at time 0.
+   */
+  virtual void OnActivate ();
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this behavior.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this behavior
+   */
+  virtual int64_t AssignStreams (int64_t stream);
+};
+
+/**
+ * \ingroup aodv
+ * \brief Black hole: answers every RREQ with a fresh one hop route and
+ * drops every packet it has to forward.
+ */
+class BlackHoleAttack : public AttackBehavior
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  BlackHoleAttack ();
+
+  bool OnRreqReceived (RreqHeader const & rreq, Ipv4Address src);
+  void OnRrepBuild (RrepHeader & rrep);
+  bool OnForward (Ptr<const Packet> p, Ipv4Header const & header);
+
+private:
+  uint32_t m_seqNoIncrement; ///< Added to the destination sequence number of forged RREPs
+};
+
+/**
+ * \ingroup aodv
+ * \brief Gray hole: attracts routes like a black hole, but drops only part
+ * of the packets it has to forward.
+ *
+ * Packets of the targeted flow are dropped with a given probability while
+ * the attack is in the on phase of its duty cycle; other packets are
+ * forwarded. The drop decisions come from a random variable of the
+ * behavior, see AssignStreams.
+ */
+class GrayHoleAttack : public BlackHoleAttack
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  GrayHoleAttack ();
+
+  bool OnForward (Ptr<const Packet> p, Ipv4Header const & header);
+  void OnActivate ();
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  /**
+   * \param header the IP header
+   * \returns true if the packet belongs to the targeted flow
+   */
+  bool IsTargeted (Ipv4Header const & header) const;
+  /**
+   * \returns true in the on phase of the duty cycle
+   */
+  bool IsOn () const;
+
+  double m_dropProbability; ///< Probability to drop a targeted packet in the on phase
+  Ipv4Address m_targetSource; ///< Source of the targeted flow, any address if 0.0.0.0
+  Ipv4Address m_targetDestination; ///< Destination of the targeted flow, any address if 0.0.0.0
+  Time m_onTime; ///< Duration of the on phase
+  Time m_offTime; ///< Duration of the off phase, 0 keeps the attack on
+  Time m_activated; ///< Time the behavior took effect, the start of the first on phase
+  Ptr<UniformRandomVariable> m_dropRv; ///< Drop decisions
+};
+
+/**
+ * \ingroup aodv
+ * \brief Hello flood: sends HELLO messages at a short interval.
+ *
+ * HELLO messages must be enabled ("EnableHello") on the attacker. Unlike a
+ * short "HelloInterval", the advertised neighbor lifetime stays derived from
+ * the configured hello interval.
+ */
+class HelloFloodAttack : public AttackBehavior
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  HelloFloodAttack ();
+
+  Time OnHelloSchedule (Time interval);
+
+private:
+  Time m_interval; ///< Interval between flooded HELLO messages
+};
+
+/**
+ * \ingroup aodv
+ * \brief Sybil hello flood: floods HELLO messages, each announcing the next
+ * of a range of spoofed identities.
+ *
+ * Every identity looks like a new neighbor to the receivers, so their
+ * routing tables and, with hello flood prevention, their per neighbor Fsm
+ * state grow with the number of identities instead of the number of
+ * attackers. The identities are "Identities" consecutive addresses starting
+ * at "FirstIdentity".
+ */
+class SybilHelloFloodAttack : public HelloFloodAttack
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  SybilHelloFloodAttack ();
+
+  Ipv4Address OnHelloOrigin (Ipv4Address origin);
+
+private:
+  Ipv4Address m_firstIdentity; ///< First spoofed identity
+  uint32_t m_identities; ///< Number of spoofed identities
+  uint32_t m_next; ///< Offset of the next identity from m_firstIdentity
+};
+
+/**
+ * \ingroup aodv
+ * \brief RREQ flood: searches routes to random nonexistent destinations at
+ * a fixed rate.
+ *
+ * Every RREQ has a fresh ID and a destination drawn from "Destinations"
+ * consecutive addresses starting at "FirstDestination", which should be
+ * unused. Flooded RREQs ignore "RreqRateLimit"; give the attacker a
+ * "TtlStart" as large as "NetDiameter" to skip the expanding ring search.
+ */
+class RreqFloodAttack : public AttackBehavior
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  RreqFloodAttack ();
+
+  Time OnRreqFloodSchedule ();
+  Ipv4Address OnRreqFloodDestination ();
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  Time m_interval; ///< Interval between flooded RREQs
+  Ipv4Address m_firstDestination; ///< First destination to search for
+  uint32_t m_destinations; ///< Number of destinations to search for
+  Ptr<UniformRandomVariable> m_destinationRv; ///< Destination choice
+};
+
+/**
+ * \ingroup aodv
+ * \brief Wormhole: one end of a pair of colluding nodes joined by an out of
+ * band tunnel.
+ *
+ * Each end copies the control packets it broadcasts to the other end, which
+ * processes them as if received from a neighbor, so the two ends look like
+ * neighbors and attract routes between the regions they join. Control and
+ * data packets sent to the other end, forwarded or originated by this end,
+ * go through the tunnel only. Every tunneled packet arrives after "Latency".
+ *
+ * The ends are joined with Connect once addresses are assigned.
+ */
+class WormholeAttack : public AttackBehavior
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WormholeAttack ();
+
+  /**
+   * Join two nodes with a tunnel. A node whose behavior is not a
+   * WormholeAttack gets a new one with default attributes.
+   * \param a the routing protocol of one end
+   * \param b the routing protocol of the other end
+   */
+  static void Connect (Ptr<RoutingProtocol> a, Ptr<RoutingProtocol> b);
+
+  bool OnControlSend (Ptr<const Packet> packet, Ipv4Address destination);
+  bool OnDataSend (Ptr<const Packet> p, Ipv4Header const & header, Ipv4Address nextHop);
+  bool OnOriginate (Ipv4Address nextHop);
+
+  /**
+   * \returns the number of control packets sent into the tunnel
+   */
+  uint64_t GetTunneledControl () const
+  {
+    return m_tunneledControl;
+  }
+  /**
+   * \returns the number of data packets sent into the tunnel
+   */
+  uint64_t GetTunneledData () const
+  {
+    return m_tunneledData;
+  }
+
+protected:
+  void DoDispose (void);
+
+private:
+  /**
+   * Join this end to a routing protocol and the other end
+   * \param protocol the routing protocol of this end
+   * \param peer the other end
+   */
+  void Attach (Ptr<RoutingProtocol> protocol, Ptr<WormholeAttack> peer);
+  /**
+   * Take a control packet out of the tunnel
+   * \param packet the packet
+   * \param sender the other end
+   */
+  void RecvControl (Ptr<Packet> packet, Ipv4Address sender);
+  /**
+   * Take a data packet out of the tunnel
+   * \param p the packet
+   * \param header the IP header
+   */
+  void RecvData (Ptr<Packet> p, Ipv4Header header);
+
+  Time m_latency; ///< Delay of the tunnel
+  RoutingProtocol * m_protocol; ///< Routing protocol of this end, which owns this behavior
+  Ptr<WormholeAttack> m_peer; ///< The other end
+  Ipv4Address m_address; ///< Address of this end
+  Ipv4Address m_broadcast; ///< Subnet directed broadcast address of this end
+  uint64_t m_tunneledControl; ///< Control packets sent into the tunnel
+  uint64_t m_tunneledData; ///< Data packets sent into the tunnel
+};
+
+/**
+ * \ingroup aodv
+ * \brief Traffic redirection: sends own packets around a suspect next hop
+ * once ExperimentalFiniteStateMachine finds it illegal.
+ *
+ * The redirection is a RoutePolicy blacklist entry, applied while the FSM
+ * finds the next hop illegal. For fixed next hop overrides and blacklists
+ * see RoutingProtocol::SetRoutePolicy.
+ */
+class TrafficRedirection : public AttackBehavior
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TrafficRedirection ();
+
+  Ptr<Ipv4Route> OnRouteOutput (Ipv4Header const & header, Ptr<Ipv4Route> route);
+
+protected:
+  void NotifyConstructionCompleted (void);
+
+private:
+  ExperimentalFiniteStateMachine m_fsm; ///< Next hop checker
+  Ipv4Address m_suspect; ///< Next hop watched by m_fsm
+  uint32_t m_tolerance; ///< Times the suspect is used before it is blacklisted
+  Time m_listTimeout; ///< Time the suspect stays blacklisted, 0 for ever
+  Ipv4Address m_redirectTo; ///< Next hop used instead of an illegal one
+  RoutePolicy m_policy; ///< Redirection of next hops found illegal by m_fsm
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_ATTACK_BEHAVIOR_H */
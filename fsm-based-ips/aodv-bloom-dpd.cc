@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-bloom-dpd.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvBloomDuplicatePacketDetection");
+
+namespace aodv {
+
+CountingBloomFilter::CountingBloomFilter (uint32_t capacity, double falsePositiveRate)
+  : m_hashes (1)
+{
+  Configure (capacity, falsePositiveRate);
+}
+
+void
+CountingBloomFilter::Configure (uint32_t capacity, double falsePositiveRate)
+{
+  NS_ASSERT_MSG (falsePositiveRate > 0 && falsePositiveRate < 1, "False positive rate must be in (0, 1)");
+  double n = std::max<uint32_t> (capacity, 1);
+  double ln2 = std::log (2.0);
+  // Optimal size m = -n ln(p) / ln(2)^2 and hash count k = m / n ln(2)
+  double m = std::ceil (-n * std::log (falsePositiveRate) / (ln2 * ln2));
+  m_counters.assign (static_cast<size_t> (std::max (m, 8.0)), 0);
+  m_hashes = std::max<uint32_t> (1, static_cast<uint32_t> (std::lround (m / n * ln2)));
+  NS_LOG_LOGIC ("Bloom filter with " << m_counters.size () << " counters and " << m_hashes << " hashes");
+}
+
+void
+CountingBloomFilter::Hash (uint64_t key, uint64_t & h1, uint64_t & h2)
+{
+  // splitmix64 finalizer
+  uint64_t z = key + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  h1 = z ^ (z >> 31);
+  h2 = (h1 >> 32) | (h1 << 32) | 1;
+}
+
+void
+CountingBloomFilter::Insert (uint64_t key)
+{
+  uint64_t h1, h2;
+  Hash (key, h1, h2);
+  for (uint32_t i = 0; i < m_hashes; ++i)
+    {
+      uint8_t & c = m_counters[Index (h1, h2, i)];
+      if (c != 255)
+        {
+          ++c;
+        }
+    }
+}
+
+void
+CountingBloomFilter::Remove (uint64_t key)
+{
+  uint64_t h1, h2;
+  Hash (key, h1, h2);
+  for (uint32_t i = 0; i < m_hashes; ++i)
+    {
+      uint8_t & c = m_counters[Index (h1, h2, i)];
+      if (c != 0 && c != 255)
+        {
+          --c;
+        }
+    }
+}
+
+bool
+CountingBloomFilter::MayContain (uint64_t key) const
+{
+  uint64_t h1, h2;
+  Hash (key, h1, h2);
+  for (uint32_t i = 0; i < m_hashes; ++i)
+    {
+      if (m_counters[Index (h1, h2, i)] == 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+CountingBloomFilter::Clear ()
+{
+  std::fill (m_counters.begin (), m_counters.end (), 0);
+}
+
+//-----------------------------------------------------------------------------
+BloomDuplicatePacketDetection::BloomDuplicatePacketDetection (Time lifetime, uint32_t capacity, double falsePositiveRate)
+  : m_filter (capacity, falsePositiveRate),
+    m_lifetime (lifetime),
+    m_negatives (0),
+    m_positives (0),
+    m_falsePositives (0)
+{
+}
+
+void
+BloomDuplicatePacketDetection::Configure (uint32_t capacity, double falsePositiveRate)
+{
+  m_filter.Configure (capacity, falsePositiveRate);
+  m_exact.clear ();
+  m_expiry.clear ();
+}
+
+bool
+BloomDuplicatePacketDetection::IsDuplicate (Ptr<const Packet> p, const Ipv4Header & header)
+{
+  Purge ();
+  Key key = { header.GetSource ().Get (), p->GetUid () };
+  uint64_t hash = KeyHash () (key);
+  if (!m_filter.MayContain (hash))
+    {
+      ++m_negatives;
+      Insert (key, hash);
+      return false;
+    }
+  ++m_positives;
+  if (m_exact.find (key) != m_exact.end ())
+    {
+      return true;
+    }
+  ++m_falsePositives;
+  Insert (key, hash);
+  return false;
+}
+
+uint64_t
+BloomDuplicatePacketDetection::KeyHash::operator() (Key const & key) const
+{
+  // The UID is 64 bits wide, so the fields are hashed separately rather than packed into one word
+  uint64_t h = std::hash<uint64_t> () (key.m_uid);
+  h ^= std::hash<uint32_t> () (key.m_source) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  return h;
+}
+
+void
+BloomDuplicatePacketDetection::Insert (Key const & key, uint64_t hash)
+{
+  m_filter.Insert (hash);
+  m_exact.insert (key);
+  Entry entry = { key, hash, m_lifetime + Simulator::Now () };
+  m_expiry.push_back (entry);
+}
+
+void
+BloomDuplicatePacketDetection::Purge ()
+{
+  Time now = Simulator::Now ();
+  while (!m_expiry.empty () && m_expiry.front ().m_expire < now)
+    {
+      m_filter.Remove (m_expiry.front ().m_hash);
+      m_exact.erase (m_expiry.front ().m_key);
+      m_expiry.pop_front ();
+    }
+}
+
+}  // namespace aodv
+}  // namespace ns3
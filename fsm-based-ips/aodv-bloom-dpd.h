@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_BLOOM_DPD_H
+#define AODV_BLOOM_DPD_H
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ *
+ * \brief Counting Bloom filter over 64 bit keys.
+ *
+ * Counters saturate at 255; a saturated counter is never decremented, so it
+ * can only add false positives, never false negatives.
+ */
+class CountingBloomFilter
+{
+public:
+  /**
+   * Constructor
+   * \param capacity expected number of simultaneously stored keys
+   * \param falsePositiveRate target false positive probability at capacity
+   */
+  CountingBloomFilter (uint32_t capacity, double falsePositiveRate);
+  /**
+   * Resize the filter for a new capacity / false positive target. Drops all keys.
+   * \param capacity expected number of simultaneously stored keys
+   * \param falsePositiveRate target false positive probability at capacity
+   */
+  void Configure (uint32_t capacity, double falsePositiveRate);
+  /**
+   * Add key
+   * \param key the key
+   */
+  void Insert (uint64_t key);
+  /**
+   * Remove key previously added with Insert
+   * \param key the key
+   */
+  void Remove (uint64_t key);
+  /**
+   * \param key the key
+   * \returns false if key was certainly never inserted
+   */
+  bool MayContain (uint64_t key) const;
+  /// Drop all keys
+  void Clear ();
+  /**
+   * \returns the number of counters
+   */
+  uint32_t GetCounterCount () const
+  {
+    return m_counters.size ();
+  }
+  /**
+   * \returns the number of hash functions
+   */
+  uint32_t GetHashCount () const
+  {
+    return m_hashes;
+  }
+
+private:
+  /**
+   * Counter index of the i-th hash of a key (double hashing)
+   * \param h1 first hash of the key
+   * \param h2 second hash of the key
+   * \param i hash function number
+   * \returns the counter index
+   */
+  uint32_t Index (uint64_t h1, uint64_t h2, uint32_t i) const
+  {
+    return static_cast<uint32_t> ((h1 + i * h2) % m_counters.size ());
+  }
+  /**
+   * Compute both hashes of a key
+   * \param key the key
+   * \param h1 first hash
+   * \param h2 second hash
+   */
+  static void Hash (uint64_t key, uint64_t & h1, uint64_t & h2);
+
+  std::vector<uint8_t> m_counters; ///< counters
+  uint32_t m_hashes;               ///< number of hash functions
+};
+
+/**
+ * \ingroup aodv
+ *
+ * \brief Broadcast duplicate packet detection with a counting Bloom prefilter.
+ *
+ * Drop-in alternative to DuplicatePacketDetection. A (source, packet UID) pair is
+ * first tested against the Bloom filter; the common "not seen" answer is returned
+ * without looking into the exact cache. Only filter hits are confirmed against the
+ * exact hashed cache. All entries share one lifetime, so expiry is kept as a FIFO.
+ */
+class BloomDuplicatePacketDetection
+{
+public:
+  /**
+   * Constructor
+   * \param lifetime the lifetime for added entries
+   * \param capacity expected number of entries alive at the same time
+   * \param falsePositiveRate target false positive probability of the prefilter
+   */
+  BloomDuplicatePacketDetection (Time lifetime, uint32_t capacity = 1024, double falsePositiveRate = 0.01);
+  /**
+   * Check if the packet is a duplicate. If not, save information about this packet.
+   * \param p the packet to check
+   * \param header the IP header to check
+   * \returns true if duplicate
+   */
+  bool IsDuplicate (Ptr<const Packet> p, const Ipv4Header & header);
+  /**
+   * Resize the prefilter. Drops all cached entries.
+   * \param capacity expected number of entries alive at the same time
+   * \param falsePositiveRate target false positive probability of the prefilter
+   */
+  void Configure (uint32_t capacity, double falsePositiveRate);
+  /**
+   * Set duplicate record lifetime
+   * \param lifetime the lifetime for duplicate records
+   */
+  void SetLifetime (Time lifetime)
+  {
+    m_lifetime = lifetime;
+  }
+  /**
+   * Get duplicate record lifetime
+   * \returns the duplicate record lifetime
+   */
+  Time GetLifetime () const
+  {
+    return m_lifetime;
+  }
+  /**
+   * \returns number of lookups answered by the prefilter alone
+   */
+  uint64_t GetFilterNegatives () const
+  {
+    return m_negatives;
+  }
+  /**
+   * \returns number of lookups that had to consult the exact cache
+   */
+  uint64_t GetFilterPositives () const
+  {
+    return m_positives;
+  }
+  /**
+   * \returns number of prefilter hits not confirmed by the exact cache
+   */
+  uint64_t GetFalsePositives () const
+  {
+    return m_falsePositives;
+  }
+
+private:
+  /// Identity of a broadcast packet
+  struct Key
+  {
+    uint32_t m_source; ///< source address
+    uint64_t m_uid;    ///< packet UID
+    /**
+     * \param o the other key
+     * \returns true if both fields are equal
+     */
+    bool operator== (Key const & o) const
+    {
+      return m_source == o.m_source && m_uid == o.m_uid;
+    }
+  };
+  /// Hash of a Key, combining the hashes of its fields
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \returns the hash
+     */
+    uint64_t operator() (Key const & key) const;
+  };
+
+  /// Remove expired entries
+  void Purge ();
+  /**
+   * Record a key
+   * \param key the key
+   * \param hash the hash of the key
+   */
+  void Insert (Key const & key, uint64_t hash);
+
+  /// Cache entry
+  struct Entry
+  {
+    Key m_key;       ///< source address and packet UID
+    uint64_t m_hash; ///< hash of m_key, as inserted into the prefilter
+    Time m_expire;   ///< expiration time
+  };
+
+  CountingBloomFilter m_filter;       ///< prefilter, keyed by the hash of a Key
+  std::unordered_set<Key, KeyHash> m_exact; ///< exact cache
+  std::deque<Entry> m_expiry;         ///< entries in insertion (= expiration) order
+  Time m_lifetime;                    ///< entry lifetime
+  uint64_t m_negatives;               ///< lookups answered by the prefilter
+  uint64_t m_positives;               ///< lookups confirmed against the exact cache
+  uint64_t m_falsePositives;          ///< prefilter hits not in the exact cache
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_BLOOM_DPD_H */
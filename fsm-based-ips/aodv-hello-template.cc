@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-hello-template.h"
+#include "aodv-packet.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvHelloTemplate");
+
+namespace aodv {
+
+/// Offset of the RREP destination, after type byte, flags, prefix size and hop count
+static const uint32_t DST_OFFSET = 4;
+/// Offset of the RREP destination sequence number, after type byte, flags, prefix size, hop count and destination
+static const uint32_t SEQNO_OFFSET = 8;
+/// Offset of the RREP origin, after destination sequence number
+static const uint32_t ORIGIN_OFFSET = 12;
+/// Offset of the RREP lifetime, after destination sequence number and origin
+static const uint32_t LIFETIME_OFFSET = 16;
+
+HelloTemplate::HelloTemplate ()
+{
+  std::memset (m_wire, 0, HELLO_SIZE);
+}
+
+HelloTemplate::HelloTemplate (Ipv4Address origin, Ipv4Address destination)
+  : m_destination (destination)
+{
+  RrepHeader helloHeader (/*prefix size=*/ 0, /*hops=*/ 0, /*dst=*/ origin, /*dst seqno=*/ 0,
+                                           /*origin=*/ origin, /*lifetime=*/ Seconds (0));
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (helloHeader);
+  packet->AddHeader (TypeHeader (AODVTYPE_RREP));
+  NS_ASSERT (packet->GetSize () == HELLO_SIZE);
+  packet->CopyData (m_wire, HELLO_SIZE);
+}
+
+void
+HelloTemplate::WriteU32 (uint32_t offset, uint32_t value)
+{
+  m_wire[offset] = (value >> 24) & 0xff;
+  m_wire[offset + 1] = (value >> 16) & 0xff;
+  m_wire[offset + 2] = (value >> 8) & 0xff;
+  m_wire[offset + 3] = value & 0xff;
+}
+
+Ptr<Packet>
+HelloTemplate::Make (uint32_t seqNo, Time lifetime)
+{
+  WriteU32 (SEQNO_OFFSET, seqNo);
+  WriteU32 (LIFETIME_OFFSET, lifetime.GetMilliSeconds ());
+  return Create<Packet> (m_wire, HELLO_SIZE);
+}
+
+void
+HelloTemplate::SetOrigin (Ipv4Address origin)
+{
+  WriteU32 (DST_OFFSET, origin.Get ());
+  WriteU32 (ORIGIN_OFFSET, origin.Get ());
+}
+
+}  // namespace aodv
+}  // namespace ns3
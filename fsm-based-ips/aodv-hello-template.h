@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_HELLO_TEMPLATE_H
+#define AODV_HELLO_TEMPLATE_H
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ *
+ * \brief Serialized HELLO message of one interface.
+ *
+ * A HELLO is a RREP whose only changing fields are the destination
+ * sequence number and the lifetime. The template keeps the wire image of
+ * the type and RREP headers and patches these two fields in place, so
+ * sending a HELLO needs neither header objects nor serialization.
+ *
+ * Every HELLO is a new packet made from the wire image rather than a
+ * Packet::Copy of a template packet: copies share the packet UID, which
+ * would make consecutive HELLOs look like duplicates of each other.
+ */
+class HelloTemplate
+{
+public:
+  /// Size of the type header and the RREP header
+  static const uint32_t HELLO_SIZE = 20;
+
+  /// Empty template
+  HelloTemplate ();
+  /**
+   * Constructor
+   * \param origin the interface address, used as HELLO destination and origin
+   * \param destination the address to send HELLOs to
+   */
+  HelloTemplate (Ipv4Address origin, Ipv4Address destination);
+  /**
+   * Make HELLO packet
+   * \param seqNo the destination sequence number
+   * \param lifetime the lifetime
+   * \returns the packet
+   */
+  Ptr<Packet> Make (uint32_t seqNo, Time lifetime);
+  /**
+   * Set the address announced as HELLO destination and origin
+   * \param origin the address
+   */
+  void SetOrigin (Ipv4Address origin);
+  /**
+   * \returns the address to send HELLOs to
+   */
+  Ipv4Address GetDestination () const
+  {
+    return m_destination;
+  }
+
+private:
+  /**
+   * Write 32 bit field in network order
+   * \param offset field offset in the wire image
+   * \param value the value
+   */
+  void WriteU32 (uint32_t offset, uint32_t value);
+
+  /// Wire image of the type and RREP headers
+  uint8_t m_wire[HELLO_SIZE];
+  /// Address to send HELLOs to
+  Ipv4Address m_destination;
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_HELLO_TEMPLATE_H */
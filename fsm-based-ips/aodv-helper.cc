@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Pavel Boyko <boyko@iitp.ru>, written after OlsrHelper by Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#include "aodv-helper.h"
+#include "ns3/aodv-routing-protocol.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/mobility-model.h"
+#include <algorithm>
+#include <deque>
+
+namespace ns3
+{
+
+AodvHelper::AodvHelper () :
+  Ipv4RoutingHelper ()
+{
+  m_agentFactory.SetTypeId ("ns3::aodv::RoutingProtocol");
+}
+
+AodvHelper*
+AodvHelper::Copy (void) const
+{
+  return new AodvHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+AodvHelper::Create (Ptr<Node> node) const
+{
+  Ptr<aodv::RoutingProtocol> agent = m_agentFactory.Create<aodv::RoutingProtocol> ();
+  std::unordered_map<uint32_t, aodv::RoutePolicy>::const_iterator policy = m_routePolicies.find (node->GetId ());
+  if (policy != m_routePolicies.end ())
+    {
+      agent->SetRoutePolicy (policy->second);
+    }
+  node->AggregateObject (agent);
+  return agent;
+}
+
+void
+AodvHelper::Set (std::string name, const AttributeValue &value)
+{
+  m_agentFactory.Set (name, value);
+}
+
+void
+AodvHelper::SetNextHop (uint32_t nodeId, Ipv4Address dst, Ipv4Address nextHop)
+{
+  m_routePolicies[nodeId].SetNextHop (dst, nextHop);
+}
+
+void
+AodvHelper::Blacklist (uint32_t nodeId, Ipv4Address nextHop, Ipv4Address redirectTo)
+{
+  m_routePolicies[nodeId].Blacklist (nextHop, redirectTo);
+}
+
+int64_t
+AodvHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  Ptr<Node> node;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      node = (*i);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (ipv4, "Ipv4 not installed on node");
+      Ptr<Ipv4RoutingProtocol> proto = ipv4->GetRoutingProtocol ();
+      NS_ASSERT_MSG (proto, "Ipv4 routing not installed on node");
+      Ptr<aodv::RoutingProtocol> aodv = DynamicCast<aodv::RoutingProtocol> (proto);
+      if (aodv)
+        {
+          currentStream += aodv->AssignStreams (currentStream);
+          continue;
+        }
+      // Aodv may also be in a list
+      Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (proto);
+      if (list)
+        {
+          int16_t priority;
+          Ptr<Ipv4RoutingProtocol> listProto;
+          Ptr<aodv::RoutingProtocol> listAodv;
+          for (uint32_t i = 0; i < list->GetNRoutingProtocols (); i++)
+            {
+              listProto = list->GetRoutingProtocol (i, priority);
+              listAodv = DynamicCast<aodv::RoutingProtocol> (listProto);
+              if (listAodv)
+                {
+                  currentStream += listAodv->AssignStreams (currentStream);
+                  break;
+                }
+            }
+        }
+    }
+  return (currentStream - stream);
+}
+
+uint32_t
+AodvHelper::SeedRoutes (NodeContainer c, std::vector<Flow> const & flows, double range, Time lifetime)
+{
+  uint32_t n = c.GetN ();
+  std::vector<Vector> positions (n);
+  std::vector<Ipv4Address> addresses (n);
+  std::vector<Ptr<aodv::RoutingProtocol> > agents (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<Node> node = c.Get (i);
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility, "Mobility not installed on node");
+      positions[i] = mobility->GetPosition ();
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (ipv4 && ipv4->GetNInterfaces () > 1, "Addresses not assigned on node");
+      addresses[i] = ipv4->GetAddress (1, 0).GetLocal ();
+      agents[i] = node->GetObject<aodv::RoutingProtocol> ();
+      NS_ASSERT_MSG (agents[i], "AODV not installed on node");
+    }
+
+  std::vector<std::vector<uint32_t> > neighbors (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      for (uint32_t j = i + 1; j < n; ++j)
+        {
+          if (CalculateDistance (positions[i], positions[j]) <= range)
+            {
+              neighbors[i].push_back (j);
+              neighbors[j].push_back (i);
+            }
+        }
+    }
+
+  uint32_t seeded = 0;
+  std::vector<uint32_t> parent (n);
+  for (std::vector<Flow>::const_iterator f = flows.begin (); f != flows.end (); ++f)
+    {
+      uint32_t src = f->first;
+      uint32_t dst = f->second;
+      NS_ASSERT (src < n && dst < n);
+      if (src == dst)
+        {
+          continue;
+        }
+      // Breadth first search from the source, parent leads back to it
+      std::fill (parent.begin (), parent.end (), n);
+      parent[src] = src;
+      std::deque<uint32_t> open (1, src);
+      while (!open.empty () && parent[dst] == n)
+        {
+          uint32_t u = open.front ();
+          open.pop_front ();
+          for (std::vector<uint32_t>::const_iterator v = neighbors[u].begin (); v != neighbors[u].end (); ++v)
+            {
+              if (parent[*v] == n)
+                {
+                  parent[*v] = u;
+                  open.push_back (*v);
+                }
+            }
+        }
+      if (parent[dst] == n)
+        {
+          continue;
+        }
+      std::vector<uint32_t> path (1, dst);
+      while (path.back () != src)
+        {
+          path.push_back (parent[path.back ()]);
+        }
+      std::reverse (path.begin (), path.end ());
+
+      uint16_t hops = path.size () - 1;
+      for (uint16_t k = 0; k < path.size (); ++k)
+        {
+          Ptr<aodv::RoutingProtocol> agent = agents[path[k]];
+          std::vector<Ipv4Address> toDstPrecursors;
+          std::vector<Ipv4Address> toSrcPrecursors;
+          if (k > 0)
+            {
+              toDstPrecursors.push_back (addresses[path[k - 1]]);
+            }
+          if (k < hops)
+            {
+              toSrcPrecursors.push_back (addresses[path[k + 1]]);
+            }
+          if (k < hops)
+            {
+              Ipv4Address next = addresses[path[k + 1]];
+              agent->SeedRoute (next, next, 1, lifetime);
+              agent->SeedRoute (addresses[dst], next, hops - k, lifetime, toDstPrecursors);
+            }
+          if (k > 0)
+            {
+              Ipv4Address prev = addresses[path[k - 1]];
+              agent->SeedRoute (prev, prev, 1, lifetime);
+              agent->SeedRoute (addresses[src], prev, k, lifetime, toSrcPrecursors);
+            }
+        }
+      ++seeded;
+    }
+  return seeded;
+}
+
+}
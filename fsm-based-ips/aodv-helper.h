@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Pavel Boyko <boyko@iitp.ru>, written after OlsrHelper by Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef AODV_HELPER_H
+#define AODV_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/aodv-route-policy.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup aodv
+ * \brief Helper class that adds AODV routing to nodes.
+ */
+class AodvHelper : public Ipv4RoutingHelper
+{
+public:
+  /// Source and destination of a flow, as indices into a NodeContainer
+  typedef std::pair<uint32_t, uint32_t> Flow;
+
+  AodvHelper ();
+
+  /**
+   * \returns pointer to clone of this AodvHelper
+   *
+   * \internal
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  AodvHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   *
+   * \todo support installing AODV on the subset of all available IP interfaces
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set.
+   *
+   * This method controls the attributes of ns3::aodv::RoutingProtocol
+   */
+  void Set (std::string name, const AttributeValue &value);
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.  The Install() method of the InternetStackHelper
+   * should have previously been called by the user.
+   *
+   * \param stream first stream index to use
+   * \param c NodeContainer of the set of nodes for which AODV
+   *          should be modified to use a fixed stream
+   * \return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+  /**
+   * Pre-seed routes of the given flows, so that they start without route
+   * discovery. Routes follow the shortest hop path over a snapshot of the
+   * current node positions, in which nodes closer than range are neighbors.
+   * Every node on a path gets the routes to both ends of the flow and to its
+   * next hops. Must be called after addresses are assigned; the first
+   * interface of each node is used.
+   *
+   * \param c the nodes running AODV, the topology is built from them only
+   * \param flows the flows
+   * \param range radio range, m
+   * \param lifetime lifetime of the seeded routes
+   * \return the number of flows whose ends are connected and got routes
+   */
+  uint32_t SeedRoutes (NodeContainer c, std::vector<Flow> const & flows, double range, Time lifetime);
+  /**
+   * Make a node send packets to a destination via the given next hop instead
+   * of the discovered one. Like attributes, route policies must be set before
+   * the helper is passed to InternetStackHelper.
+   *
+   * \param nodeId the node id
+   * \param dst the destination IP address
+   * \param nextHop the next hop IP address
+   */
+  void SetNextHop (uint32_t nodeId, Ipv4Address dst, Ipv4Address nextHop);
+  /**
+   * Make a node never send via a next hop, sending via another one instead.
+   * Like attributes, route policies must be set before the helper is passed
+   * to InternetStackHelper.
+   *
+   * \param nodeId the node id
+   * \param nextHop the blacklisted next hop IP address
+   * \param redirectTo the next hop IP address used instead
+   */
+  void Blacklist (uint32_t nodeId, Ipv4Address nextHop, Ipv4Address redirectTo);
+
+private:
+  /** the factory to create AODV routing object */
+  ObjectFactory m_agentFactory;
+  /// Route policy per node id
+  std::unordered_map<uint32_t, aodv::RoutePolicy> m_routePolicies;
+};
+
+}
+
+#endif /* AODV_HELPER_H */
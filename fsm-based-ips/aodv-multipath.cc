@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-multipath.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvMultipath");
+
+namespace aodv {
+
+AlternatePathTable::AlternatePathTable (uint32_t maxPaths)
+  : m_maxPaths (maxPaths)
+{
+}
+
+void
+AlternatePathTable::Purge (PathList & paths)
+{
+  Time now = Simulator::Now ();
+  for (PathList::iterator i = paths.begin (); i != paths.end (); )
+    {
+      if (i->m_expire < now)
+        {
+          i = paths.erase (i);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+void
+AlternatePathTable::Add (Ipv4Address dst, AlternatePath const & path)
+{
+  if (m_maxPaths == 0)
+    {
+      return;
+    }
+  PathList & paths = m_paths[dst];
+  Purge (paths);
+  for (PathList::iterator i = paths.begin (); i != paths.end (); )
+    {
+      int32_t age = int32_t (path.m_seqNo) - int32_t (i->m_seqNo);
+      if (age < 0)
+        {
+          NS_LOG_LOGIC ("Ignore path to " << dst << " via " << path.m_nextHop << " with old seqno");
+          return;
+        }
+      if (age > 0 || i->m_nextHop == path.m_nextHop)
+        {
+          i = paths.erase (i);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+  if (paths.size () < m_maxPaths)
+    {
+      paths.push_back (path);
+    }
+  else
+    {
+      PathList::iterator longest = paths.begin ();
+      for (PathList::iterator i = paths.begin (); i != paths.end (); ++i)
+        {
+          if (i->m_hops > longest->m_hops)
+            {
+              longest = i;
+            }
+        }
+      if (longest != paths.end () && path.m_hops < longest->m_hops)
+        {
+          *longest = path;
+        }
+    }
+  NS_LOG_LOGIC (paths.size () << " alternate paths to " << dst);
+}
+
+bool
+AlternatePathTable::Take (Ipv4Address dst, Ipv4Address excluded, AlternatePath & path)
+{
+  std::unordered_map<Ipv4Address, PathList, Ipv4AddressHash>::iterator i = m_paths.find (dst);
+  if (i == m_paths.end ())
+    {
+      return false;
+    }
+  PathList & paths = i->second;
+  Purge (paths);
+  for (PathList::iterator j = paths.begin (); j != paths.end (); )
+    {
+      if (j->m_nextHop == excluded)
+        {
+          j = paths.erase (j);
+        }
+      else
+        {
+          ++j;
+        }
+    }
+  PathList::iterator best = paths.begin ();
+  for (PathList::iterator j = paths.begin (); j != paths.end (); ++j)
+    {
+      if (j->m_hops < best->m_hops)
+        {
+          best = j;
+        }
+    }
+  if (best == paths.end ())
+    {
+      m_paths.erase (i);
+      return false;
+    }
+  path = *best;
+  paths.erase (best);
+  if (paths.empty ())
+    {
+      m_paths.erase (i);
+    }
+  return true;
+}
+
+void
+AlternatePathTable::RemoveNextHop (Ipv4Address nextHop)
+{
+  for (std::unordered_map<Ipv4Address, PathList, Ipv4AddressHash>::iterator i = m_paths.begin (); i != m_paths.end (); )
+    {
+      PathList & paths = i->second;
+      for (PathList::iterator j = paths.begin (); j != paths.end (); )
+        {
+          if (j->m_nextHop == nextHop)
+            {
+              j = paths.erase (j);
+            }
+          else
+            {
+              ++j;
+            }
+        }
+      if (paths.empty ())
+        {
+          i = m_paths.erase (i);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+uint32_t
+AlternatePathTable::GetSize (Ipv4Address dst) const
+{
+  std::unordered_map<Ipv4Address, PathList, Ipv4AddressHash>::const_iterator i = m_paths.find (dst);
+  return i == m_paths.end () ? 0 : i->second.size ();
+}
+
+}  // namespace aodv
+}  // namespace ns3
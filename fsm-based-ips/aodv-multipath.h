@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_MULTIPATH_H
+#define AODV_MULTIPATH_H
+
+#include "ns3/nstime.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface-address.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ * \brief Alternate path to a destination, not installed in the routing table
+ */
+struct AlternatePath
+{
+  /// Next hop
+  Ipv4Address m_nextHop;
+  /// Output device
+  Ptr<NetDevice> m_device;
+  /// Output interface address
+  Ipv4InterfaceAddress m_iface;
+  /// Hop count
+  uint16_t m_hops;
+  /// Destination sequence number the path was learned with
+  uint32_t m_seqNo;
+  /// Expiration time
+  Time m_expire;
+};
+
+/**
+ * \ingroup aodv
+ * \brief Alternate paths per destination (AOMDV style multipath).
+ *
+ * Keeps up to MaxPaths next hop disjoint paths per destination besides
+ * the one in the routing table. Paths learned with an older destination
+ * sequence number than the freshest known one are dropped.
+ */
+class AlternatePathTable
+{
+public:
+  /**
+   * Constructor
+   * \param maxPaths the maximum number of alternate paths per destination
+   */
+  AlternatePathTable (uint32_t maxPaths);
+  /**
+   * \param maxPaths the maximum number of alternate paths per destination
+   */
+  void SetMaxPaths (uint32_t maxPaths)
+  {
+    m_maxPaths = maxPaths;
+  }
+  /**
+   * Add alternate path. A path through the same next hop is replaced. When
+   * the destination already has MaxPaths paths, the new path replaces the
+   * longest one if it is shorter.
+   * \param dst the destination
+   * \param path the path
+   */
+  void Add (Ipv4Address dst, AlternatePath const & path);
+  /**
+   * Remove the shortest live path to destination from the table
+   * \param dst the destination
+   * \param excluded next hop not to use; paths through it are dropped
+   * \param path the path
+   * \returns true if a path is found
+   */
+  bool Take (Ipv4Address dst, Ipv4Address excluded, AlternatePath & path);
+  /**
+   * Drop all paths through next hop
+   * \param nextHop the next hop
+   */
+  void RemoveNextHop (Ipv4Address nextHop);
+  /// Drop all paths
+  void Clear ()
+  {
+    m_paths.clear ();
+  }
+  /**
+   * \param dst the destination
+   * \returns the number of alternate paths to destination, including expired ones
+   */
+  uint32_t GetSize (Ipv4Address dst) const;
+
+private:
+  /// Alternate paths of one destination
+  typedef std::vector<AlternatePath> PathList;
+
+  /**
+   * Drop expired paths
+   * \param paths the paths of one destination
+   */
+  static void Purge (PathList & paths);
+
+  /// Maximum number of paths per destination
+  uint32_t m_maxPaths;
+  /// Alternate paths per destination
+  std::unordered_map<Ipv4Address, PathList, Ipv4AddressHash> m_paths;
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_MULTIPATH_H */
@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Based on
+ *      NS-2 AODV model developed by the CMU/MONARCH group and optimized and
+ *      tuned by Samir Das and Mahesh Marina, University of Cincinnati;
+ *
+ *      AODV-UU implementation by Erik Nordström of Uppsala University
+ *      http://core.it.uu.se/core/index.php/AODV-UU
+ *
+ * Authors: Elena Buchatskaia <borovkovaes@iitp.ru>
+ *          Pavel Boyko <boyko@iitp.ru>
+ */
+
+#include <algorithm>
+#include "aodv-neighbor.h"
+#include "ns3/log.h"
+#include "ns3/wifi-mac-header.h"
+
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvNeighbors");
+
+namespace aodv {
+Neighbors::Neighbors (Time delay)
+  : m_ntimer (Timer::CANCEL_ON_DESTROY),
+    m_bucketWidth (delay)
+{
+  NS_ASSERT (delay.IsStrictlyPositive ());
+  m_ntimer.SetDelay (delay);
+  m_ntimer.SetFunction (&Neighbors::Purge, this);
+  m_txErrorCallback = MakeCallback (&Neighbors::ProcessTxError, this);
+}
+
+bool
+Neighbors::IsNeighbor (Ipv4Address addr)
+{
+  Purge ();
+  return m_nb.find (addr) != m_nb.end ();
+}
+
+Time
+Neighbors::GetExpireTime (Ipv4Address addr)
+{
+  Purge ();
+  NeighborTable::const_iterator i = m_nb.find (addr);
+  if (i != m_nb.end ())
+    {
+      return (i->second.m_expireTime - Simulator::Now ());
+    }
+  return Seconds (0);
+}
+
+void
+Neighbors::Update (Ipv4Address addr, Time expire)
+{
+  NeighborTable::iterator i = m_nb.find (addr);
+  if (i != m_nb.end ())
+    {
+      Neighbor & nb = i->second;
+      nb.m_expireTime = std::max (expire + Simulator::Now (), nb.m_expireTime);
+      if (nb.m_hardwareAddress == Mac48Address ())
+        {
+          nb.m_hardwareAddress = LookupMacAddress (nb.m_neighborAddress);
+        }
+      File (nb);
+      return;
+    }
+
+  NS_LOG_LOGIC ("Open link to " << addr);
+  Neighbor neighbor (addr, LookupMacAddress (addr), expire + Simulator::Now ());
+  neighbor.m_bucket = -1;
+  File (m_nb.insert (std::make_pair (addr, neighbor)).first->second);
+  Purge ();
+}
+
+void
+Neighbors::File (Neighbor & nb)
+{
+  int64_t bucket = nb.m_expireTime.GetInteger () / m_bucketWidth.GetInteger ();
+  if (bucket != nb.m_bucket)
+    {
+      nb.m_bucket = bucket;
+      m_buckets[bucket].push_back (nb.m_neighborAddress);
+    }
+}
+
+void
+Neighbors::Purge ()
+{
+  if (m_nb.empty ())
+    {
+      return;
+    }
+
+  // Collect links to close first: the link failure callback may update the table.
+  std::vector<Ipv4Address> close;
+  close.swap (m_closed);
+  int64_t now = Simulator::Now ().GetInteger () / m_bucketWidth.GetInteger ();
+  while (!m_buckets.empty () && m_buckets.begin ()->first <= now)
+    {
+      std::vector<Ipv4Address> pending;
+      pending.swap (m_buckets.begin ()->second);
+      int64_t bucket = m_buckets.begin ()->first;
+      m_buckets.erase (m_buckets.begin ());
+      std::vector<Ipv4Address> keep;
+      for (std::vector<Ipv4Address>::const_iterator j = pending.begin (); j != pending.end (); ++j)
+        {
+          NeighborTable::const_iterator i = m_nb.find (*j);
+          if (i == m_nb.end () || i->second.m_bucket != bucket)
+            {
+              continue; // stale record
+            }
+          if (IsClosed (i->second))
+            {
+              close.push_back (*j);
+            }
+          else
+            {
+              keep.push_back (*j);
+            }
+        }
+      if (!keep.empty ())
+        {
+          // Only the current bucket may hold neighbors that have not expired yet
+          m_buckets[bucket].swap (keep);
+          break;
+        }
+    }
+
+  if (!m_handleLinkFailure.IsNull ())
+    {
+      for (std::vector<Ipv4Address>::const_iterator j = close.begin (); j != close.end (); ++j)
+        {
+          NeighborTable::const_iterator i = m_nb.find (*j);
+          if (i != m_nb.end () && IsClosed (i->second))
+            {
+              NS_LOG_LOGIC ("Close link to " << *j);
+              m_handleLinkFailure (*j);
+            }
+        }
+    }
+  for (std::vector<Ipv4Address>::const_iterator j = close.begin (); j != close.end (); ++j)
+    {
+      NeighborTable::iterator i = m_nb.find (*j);
+      if (i != m_nb.end () && IsClosed (i->second))
+        {
+          m_nb.erase (i);
+        }
+    }
+  m_ntimer.Cancel ();
+  m_ntimer.Schedule ();
+}
+
+void
+Neighbors::ScheduleTimer ()
+{
+  m_ntimer.Cancel ();
+  m_ntimer.Schedule ();
+}
+
+void
+Neighbors::AddArpCache (Ptr<ArpCache> a)
+{
+  m_arp.push_back (a);
+}
+
+void
+Neighbors::DelArpCache (Ptr<ArpCache> a)
+{
+  m_arp.erase (std::remove (m_arp.begin (), m_arp.end (), a), m_arp.end ());
+}
+
+Mac48Address
+Neighbors::LookupMacAddress (Ipv4Address addr)
+{
+  Mac48Address hwaddr;
+  for (std::vector<Ptr<ArpCache> >::const_iterator i = m_arp.begin ();
+       i != m_arp.end (); ++i)
+    {
+      ArpCache::Entry * entry = (*i)->Lookup (addr);
+      if (entry != 0 && (entry->IsAlive () || entry->IsPermanent ()) && !entry->IsExpired ())
+        {
+          hwaddr = Mac48Address::ConvertFrom (entry->GetMacAddress ());
+          break;
+        }
+    }
+  return hwaddr;
+}
+
+void
+Neighbors::ProcessTxError (WifiMacHeader const & hdr)
+{
+  Mac48Address addr = hdr.GetAddr1 ();
+
+  for (NeighborTable::iterator i = m_nb.begin (); i != m_nb.end (); ++i)
+    {
+      if (i->second.m_hardwareAddress == addr && !i->second.close)
+        {
+          i->second.close = true;
+          m_closed.push_back (i->first);
+        }
+    }
+  Purge ();
+}
+
+}  // namespace aodv
+}  // namespace ns3
@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-packet-view.h"
+
+namespace ns3 {
+namespace aodv {
+
+AodvPacketView::AodvPacketView (Ptr<const Packet> p)
+  : m_size (p->GetSize () < MAX_VIEW_SIZE ? p->GetSize () : MAX_VIEW_SIZE)
+{
+  p->CopyData (m_data, m_size);
+}
+
+bool
+AodvPacketView::IsValid () const
+{
+  // Type header is 1 byte; RREQ is 23 bytes, RREP 19, RERR at least 3 and RREP_ACK 1
+  switch (GetTypeByte ())
+    {
+    case AODVTYPE_RREQ:
+      return m_size >= 24;
+    case AODVTYPE_RREP:
+      return m_size >= 20;
+    case AODVTYPE_RERR:
+      return m_size >= 4;
+    case AODVTYPE_RREP_ACK:
+      return m_size >= 2;
+    default:
+      return false;
+    }
+}
+
+}  // namespace aodv
+}  // namespace ns3
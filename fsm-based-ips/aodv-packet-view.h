@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_PACKET_VIEW_H
+#define AODV_PACKET_VIEW_H
+
+#include "aodv-packet.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ *
+ * \brief Read only view of the leading fields of an AODV control packet.
+ *
+ * Copies the type header and the fixed part of the RREQ / RREP header
+ * (at most 24 bytes) out of the packet and reads fields in place, without
+ * deserializing header objects or removing anything from the packet.
+ * Used for the checks that may drop the packet before the full header is
+ * needed.
+ */
+class AodvPacketView
+{
+public:
+  /**
+   * Constructor
+   * \param p the packet starting with the AODV type header
+   */
+  AodvPacketView (Ptr<const Packet> p);
+  /**
+   * \returns true if the type is known and the packet is long enough for its fixed header
+   */
+  bool IsValid () const;
+  /**
+   * \returns the raw type byte
+   */
+  uint8_t GetTypeByte () const
+  {
+    return m_size > 0 ? m_data[0] : 0;
+  }
+  /**
+   * \returns the message type, valid only if IsValid ()
+   */
+  MessageType GetType () const
+  {
+    return static_cast<MessageType> (GetTypeByte ());
+  }
+
+  ///\name RREQ fields
+  //\{
+  /// \returns the RREQ hop count
+  uint8_t GetRreqHopCount () const
+  {
+    return m_data[3];
+  }
+  /// \returns the RREQ ID
+  uint32_t GetRreqId () const
+  {
+    return ReadU32 (4);
+  }
+  /// \returns the RREQ destination address
+  Ipv4Address GetRreqDst () const
+  {
+    return Ipv4Address (ReadU32 (8));
+  }
+  /// \returns the RREQ originator address
+  Ipv4Address GetRreqOrigin () const
+  {
+    return Ipv4Address (ReadU32 (16));
+  }
+  /// \returns the RREQ originator sequence number
+  uint32_t GetRreqOriginSeqno () const
+  {
+    return ReadU32 (20);
+  }
+  //\}
+
+  ///\name RREP fields
+  //\{
+  /// \returns the RREP hop count
+  uint8_t GetRrepHopCount () const
+  {
+    return m_data[3];
+  }
+  /// \returns the RREP destination address
+  Ipv4Address GetRrepDst () const
+  {
+    return Ipv4Address (ReadU32 (4));
+  }
+  /// \returns the RREP destination sequence number
+  uint32_t GetRrepDstSeqno () const
+  {
+    return ReadU32 (8);
+  }
+  /// \returns the RREP originator address
+  Ipv4Address GetRrepOrigin () const
+  {
+    return Ipv4Address (ReadU32 (12));
+  }
+  /// \returns the RREP lifetime
+  Time GetRrepLifeTime () const
+  {
+    return MilliSeconds (ReadU32 (16));
+  }
+  /// \returns true if the RREP is a HELLO message
+  bool IsHello () const
+  {
+    return GetRrepDst () == GetRrepOrigin ();
+  }
+  //\}
+
+private:
+  /// Longest fixed part: type header and RREQ header
+  static const uint32_t MAX_VIEW_SIZE = 24;
+
+  /**
+   * Read 32 bit field stored in network order
+   * \param offset field offset from the start of the packet
+   * \returns the value
+   */
+  uint32_t ReadU32 (uint32_t offset) const
+  {
+    NS_ASSERT (offset + 4 <= m_size);
+    return (uint32_t (m_data[offset]) << 24) | (uint32_t (m_data[offset + 1]) << 16)
+           | (uint32_t (m_data[offset + 2]) << 8) | uint32_t (m_data[offset + 3]);
+  }
+
+  /// Leading bytes of the packet
+  uint8_t m_data[MAX_VIEW_SIZE];
+  /// Number of valid bytes in m_data
+  uint32_t m_size;
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_PACKET_VIEW_H */
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-route-policy.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvRoutePolicy");
+
+namespace aodv {
+
+void
+RoutePolicy::SetNextHop (Ipv4Address dst, Ipv4Address nextHop)
+{
+  m_nextHops[dst] = nextHop;
+}
+
+void
+RoutePolicy::Blacklist (Ipv4Address nextHop, Ipv4Address redirectTo)
+{
+  NS_ASSERT (nextHop != redirectTo);
+  m_blacklist[nextHop] = redirectTo;
+}
+
+Ipv4Address
+RoutePolicy::GetNextHop (Ipv4Address dst, Ipv4Address nextHop) const
+{
+  std::unordered_map<Ipv4Address, Ipv4Address, Ipv4AddressHash>::const_iterator i = m_nextHops.find (dst);
+  if (i != m_nextHops.end ())
+    {
+      return i->second;
+    }
+  i = m_blacklist.find (nextHop);
+  if (i != m_blacklist.end ())
+    {
+      return i->second;
+    }
+  return nextHop;
+}
+
+Ptr<Ipv4Route>
+RoutePolicy::Apply (Ptr<Ipv4Route> route) const
+{
+  if (IsEmpty ())
+    {
+      return route;
+    }
+  Ipv4Address nextHop = GetNextHop (route->GetDestination (), route->GetGateway ());
+  if (nextHop == route->GetGateway ())
+    {
+      return route;
+    }
+  NS_LOG_LOGIC ("Send packet to " << route->GetDestination () << " via " << nextHop
+                                  << " instead of " << route->GetGateway ());
+  // The route belongs to the routing table, send along a copy
+  Ptr<Ipv4Route> redirected = Create<Ipv4Route> (*route);
+  redirected->SetGateway (nextHop);
+  return redirected;
+}
+
+void
+RoutePolicy::Clear ()
+{
+  m_nextHops.clear ();
+  m_blacklist.clear ();
+}
+
+}  // namespace aodv
+}  // namespace ns3
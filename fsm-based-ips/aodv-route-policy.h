@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_ROUTE_POLICY_H
+#define AODV_ROUTE_POLICY_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+
+#include <unordered_map>
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ * \brief Next hop policy of one node.
+ *
+ * Overrides the next hop of discovered routes: per destination overrides
+ * send all packets to a destination via a given neighbor, and blacklisted
+ * next hops are replaced by a given neighbor for every destination. A
+ * destination override wins over the blacklist. Both lookups are hash
+ * table lookups, so the policy costs the same regardless of its size.
+ */
+class RoutePolicy
+{
+public:
+  /**
+   * Send packets to dst via nextHop
+   * \param dst the destination IP address
+   * \param nextHop the next hop IP address
+   */
+  void SetNextHop (Ipv4Address dst, Ipv4Address nextHop);
+  /**
+   * Never send via nextHop, send via redirectTo instead
+   * \param nextHop the blacklisted next hop IP address
+   * \param redirectTo the next hop IP address used instead
+   */
+  void Blacklist (Ipv4Address nextHop, Ipv4Address redirectTo);
+  /**
+   * \param dst the destination IP address
+   * \param nextHop the next hop of the discovered route
+   * \returns the next hop to use
+   */
+  Ipv4Address GetNextHop (Ipv4Address dst, Ipv4Address nextHop) const;
+  /**
+   * Apply policy to a route
+   * \param route the route, it is not modified
+   * \returns route itself or a copy with the next hop replaced
+   */
+  Ptr<Ipv4Route> Apply (Ptr<Ipv4Route> route) const;
+  /**
+   * \returns true if the policy changes no route
+   */
+  bool IsEmpty () const
+  {
+    return m_nextHops.empty () && m_blacklist.empty ();
+  }
+  /// Remove all overrides and blacklisted next hops
+  void Clear ();
+
+private:
+  /// Next hop override per destination
+  std::unordered_map<Ipv4Address, Ipv4Address, Ipv4AddressHash> m_nextHops;
+  /// Replacement per blacklisted next hop
+  std::unordered_map<Ipv4Address, Ipv4Address, Ipv4AddressHash> m_blacklist;
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_ROUTE_POLICY_H */
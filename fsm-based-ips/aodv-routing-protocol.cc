@@ -32,6 +32,7 @@
 #include "aodv-routing-protocol.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/trace-source-accessor.h"
@@ -43,6 +44,8 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <limits>
 
 namespace ns3 {
@@ -163,18 +166,41 @@ RoutingProtocol::RoutingProtocol ()
     m_gratuitousReply (true),
     m_enableHello (false),
     m_enableHelloFloodPrevention(false),
+    m_enableDpdPrefilter (false),
+    m_dpdPrefilterCapacity (1024),
+    m_dpdPrefilterFpRate (0.01),
+    m_rerrAggregationWindow (Seconds (0)),
+    m_enableMultipath (false),
+    m_maxAlternatePaths (3),
+    m_enableLocalRepair (false),
+    m_maxRepairTtl (10),
+    m_localAddTtl (2),
+    m_isBlackHole (false),
+    m_attackStart (Seconds (0)),
+    m_attackStop (Seconds (0)),
     m_routingTable (m_deletePeriod),
     m_queue (m_maxQueueLen, m_maxQueueTime),
     m_requestId (0),
     m_seqNo (0),
     m_rreqIdCache (m_pathDiscoveryTime),
     m_dpd (m_pathDiscoveryTime),
+    m_dpdPrefilter (m_pathDiscoveryTime),
     m_nb (m_helloInterval),
-    m_rreqCount (0),
+    m_alternatePaths (m_maxAlternatePaths),
+    m_honest (CreateObject<AttackBehavior> ()),
+    m_attackBehavior (m_honest),
+    m_attack (m_honest),
+    m_attackActive (true),
+    m_rreqTokens (m_rreqRateLimit),
+    m_rreqTokensUpdate (Seconds (0)),
     m_rerrCount (0),
-    m_htimer (Timer::CANCEL_ON_DESTROY),
-    m_rreqRateLimitTimer (Timer::CANCEL_ON_DESTROY),
-    m_rerrRateLimitTimer (Timer::CANCEL_ON_DESTROY),
+    m_htimer (0),
+    m_rreqFloodTimer (0),
+    m_rreqReleaseTimer (0),
+    m_rerrRateLimitTimer (0),
+    m_addressReqTimer (m_timers),
+    m_rerrFlushTimer (0),
+    m_rerrBroadcast (false),
     m_lastBcastTime (Seconds (0))
 {
   calculationsStartCallback.Nullify();
@@ -182,6 +208,15 @@ RoutingProtocol::RoutingProtocol ()
   m_nb.SetCallback (MakeCallback (&RoutingProtocol::SendRerrWhenBreaksLinkToNextHop, this));
 }
 
+/// Factory of the honest node behavior, default of the AttackBehavior attribute
+static ObjectFactory
+HonestBehaviorFactory ()
+{
+  ObjectFactory factory;
+  factory.SetTypeId (AttackBehavior::GetTypeId ());
+  return factory;
+}
+
 TypeId
 RoutingProtocol::GetTypeId (void)
 {
@@ -295,6 +330,62 @@ RoutingProtocol::GetTypeId (void)
                    MakeBooleanAccessor (&RoutingProtocol::SetHelloFloodPrevention,
                                         &RoutingProtocol::GetHelloFloodPrevention),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableDpdPrefilter", "Indicates whether a counting Bloom prefilter is used for broadcast duplicate detection.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_enableDpdPrefilter),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DpdPrefilterCapacity", "Expected number of broadcast duplicate detection records alive at the same time.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&RoutingProtocol::m_dpdPrefilterCapacity),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DpdPrefilterFalsePositiveRate", "Target false positive rate of the broadcast duplicate detection prefilter.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&RoutingProtocol::m_dpdPrefilterFpRate),
+                   MakeDoubleChecker<double> (1e-9, 0.5))
+    .AddAttribute ("RerrAggregationWindow", "Time RERR messages are held to merge unreachable destinations "
+                   "of several link breaks into one RERR. Zero sends every RERR at once.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_rerrAggregationWindow),
+                   MakeTimeChecker ())
+    .AddAttribute ("EnableMultipath", "Keep next hop disjoint alternate paths learned from duplicate RREQs "
+                   "and unused RREPs and fail over to them when a route breaks.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_enableMultipath),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxAlternatePaths", "Maximum number of alternate paths kept per destination.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&RoutingProtocol::m_maxAlternatePaths),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EnableLocalRepair", "Indicates whether an intermediate node repairs a broken route "
+                   "with a bounded RREQ search instead of reporting the destination unreachable.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_enableLocalRepair),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRepairTtl", "Maximum hop count to a destination for which local repair is tried.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&RoutingProtocol::m_maxRepairTtl),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("LocalAddTtl", "TTL added to the last known hop count in the local repair RREQ.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&RoutingProtocol::m_localAddTtl),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("AttackBehavior", "Behavior of the node at attack points, e.g. "
+                   "\"ns3::aodv::HelloFloodAttack[Interval=10ms]\". The default is an honest node.",
+                   ObjectFactoryValue (HonestBehaviorFactory ()),
+                   MakeObjectFactoryAccessor (&RoutingProtocol::m_attackFactory),
+                   MakeObjectFactoryChecker ())
+    .AddAttribute ("IsBlackHole", "Is the node a black hole, same as AttackBehavior ns3::aodv::BlackHoleAttack.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_isBlackHole),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AttackStart", "Simulation time the attack behavior is switched on.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_attackStart),
+                   MakeTimeChecker ())
+    .AddAttribute ("AttackStop", "Simulation time the attack behavior is switched off, 0 keeps it on.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_attackStop),
+                   MakeTimeChecker ())
     .AddAttribute ("EnableBroadcast", "Indicates whether a broadcast data packets forwarding enable.",
                    BooleanValue (true),
                    MakeBooleanAccessor (&RoutingProtocol::SetBroadcastEnable,
@@ -305,6 +396,9 @@ RoutingProtocol::GetTypeId (void)
                    StringValue ("ns3::UniformRandomVariable"),
                    MakePointerAccessor (&RoutingProtocol::m_uniformRandomVariable),
                    MakePointerChecker<UniformRandomVariable> ())
+    .AddTraceSource ("AttackStateChanged", "The attack behavior was switched on (true) or off (false).",
+                     MakeTraceSourceAccessor (&RoutingProtocol::m_attackStateChangedTrace),
+                     "ns3::aodv::RoutingProtocol::AttackStateTracedCallback")
 
   ;
   return tid;
@@ -343,6 +437,18 @@ RoutingProtocol::DoDispose ()
       iter->first->Close ();
     }
   m_socketSubnetBroadcastAddresses.clear ();
+  m_helloTemplates.clear ();
+  m_alternatePaths.Clear ();
+  m_localRepair.clear ();
+  m_timers.CancelAll ();
+  // Behaviors may hold references to other nodes' behaviors, e.g. a wormhole peer
+  if (m_attackBehavior)
+    {
+      m_attackBehavior->Dispose ();
+    }
+  m_attackBehavior = 0;
+  m_attack = 0;
+  m_honest = 0;
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -363,7 +469,47 @@ RoutingProtocol::AssignStreams (int64_t stream)
 {
   NS_LOG_FUNCTION (this << stream);
   m_uniformRandomVariable->SetStream (stream);
-  return 1;
+  return 1 + m_attackBehavior->AssignStreams (stream + 1);
+}
+
+void
+RoutingProtocol::SeedRoute (Ipv4Address dst, Ipv4Address nextHop, uint16_t hops, Time lifetime,
+                            std::vector<Ipv4Address> const & precursors)
+{
+  NS_LOG_FUNCTION (this << dst << nextHop << hops);
+  NS_ASSERT_MSG (!m_socketAddresses.empty (), "No AODV interfaces, assign addresses first");
+  Ipv4InterfaceAddress iface = m_socketAddresses.begin ()->second;
+  for (std::map<Ptr<Socket>, Ipv4InterfaceAddress>::const_iterator j =
+         m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
+    {
+      if (j->second.GetMask ().IsMatch (j->second.GetLocal (), nextHop))
+        {
+          iface = j->second;
+          break;
+        }
+    }
+  Ptr<NetDevice> dev = m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (iface.GetLocal ()));
+  RoutingTableEntry newEntry (/*device=*/ dev, /*dst=*/ dst, /*validSeqNo=*/ false, /*seqno=*/ 0,
+                                          /*iface=*/ iface, /*hops=*/ hops, /*nextHop=*/ nextHop, /*lifeTime=*/ lifetime);
+  for (std::vector<Ipv4Address>::const_iterator j = precursors.begin (); j != precursors.end (); ++j)
+    {
+      newEntry.InsertPrecursor (*j);
+    }
+  RoutingTableEntry rt;
+  if (m_routingTable.LookupRoute (dst, rt))
+    {
+      std::vector<Ipv4Address> known;
+      rt.GetPrecursors (known);
+      for (std::vector<Ipv4Address>::const_iterator j = known.begin (); j != known.end (); ++j)
+        {
+          newEntry.InsertPrecursor (*j);
+        }
+      m_routingTable.Update (newEntry);
+    }
+  else
+    {
+      m_routingTable.AddRoute (newEntry);
+    }
 }
 
 void
@@ -374,13 +520,12 @@ RoutingProtocol::Start ()
     {
       m_nb.ScheduleTimer ();
     }
-  m_rreqRateLimitTimer.SetFunction (&RoutingProtocol::RreqRateLimitTimerExpire,
-                                    this);
-  m_rreqRateLimitTimer.Schedule (Seconds (1));
+  m_rreqTokens = m_rreqRateLimit;
+  m_rreqTokensUpdate = Simulator::Now ();
+  m_alternatePaths.SetMaxPaths (m_maxAlternatePaths);
 
-  m_rerrRateLimitTimer.SetFunction (&RoutingProtocol::RerrRateLimitTimerExpire,
-                                    this);
-  m_rerrRateLimitTimer.Schedule (Seconds (1));
+  m_rerrRateLimitTimer = m_timers.Schedule (Seconds (1),
+                                             std::bind (&RoutingProtocol::RerrRateLimitTimerExpire, this));
 
 }
 
@@ -415,6 +560,10 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
   Ptr<Ipv4Route> route;
   Ipv4Address dst = header.GetDestination ();
   RoutingTableEntry rt;
+  if (m_enableMultipath && !m_routingTable.LookupValidRoute (dst, rt))
+    {
+      FailOver (dst, Ipv4Address ());
+    }
   if (m_routingTable.LookupValidRoute (dst, rt))
     {
       route = rt.GetRoute ();
@@ -431,6 +580,22 @@ RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
         }
       UpdateRouteLifeTime (dst, m_activeRouteTimeout);
       UpdateRouteLifeTime (route->GetGateway (), m_activeRouteTimeout);
+      route = m_attack->OnRouteOutput (header, m_routePolicy.Apply (route));
+      if (m_attack->OnOriginate (route->GetGateway ()))
+        {
+          // The packet is not fully formed yet; it is offered to the attack behavior
+          // when it comes back from the loopback to RouteInput
+          NS_LOG_DEBUG ("Loop back packet " << p->GetUid () << " for attack behavior");
+          DeferredRouteOutputTag tag (oif ? m_ipv4->GetInterfaceForDevice (oif) : -1);
+          if (!p->PeekPacketTag (tag))
+            {
+              p->AddPacketTag (tag);
+            }
+          if (!this->calculationsStopCallback.IsNull()) {
+            this->calculationsStopCallback();
+          }
+          return LoopbackRoute (header, oif);
+        }
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
       }
@@ -491,16 +656,12 @@ RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
     this->calculationsStartCallback();
   }
 
-  if (this->m_enableHelloFloodPrevention)
+  if (this->m_enableHelloFloodPrevention && Fsms::IsBlocked(header.GetSource()))
   {
-    Fsm& fsm = Fsms::Get(header.GetSource());
-    if (fsm.IsMalicious())
-    {
-      if (!this->calculationsStopCallback.IsNull()) {
-        this->calculationsStopCallback();
-      }
-      return false;
+    if (!this->calculationsStopCallback.IsNull()) {
+      this->calculationsStopCallback();
     }
+    return false;
   }
 
 
@@ -528,6 +689,17 @@ RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
       DeferredRouteOutputTag tag;
       if (p->PeekPacketTag (tag))
         {
+          // Looped back by RouteOutput for the attack behavior: offer it along the same route
+          RoutingTableEntry toDst;
+          if (m_routingTable.LookupValidRoute (dst, toDst)
+              && m_attack->OnDataSend (p, header, m_attack->OnRouteOutput (header, m_routePolicy.Apply (toDst.GetRoute ()))->GetGateway ()))
+            {
+              NS_LOG_DEBUG ("Packet " << p->GetUid () << " taken by attack behavior");
+              if (!this->calculationsStopCallback.IsNull()) {
+                this->calculationsStopCallback();
+              }
+              return true;
+            }
           DeferredRouteOutput (p, header, ucb, ecb);
           if (!this->calculationsStopCallback.IsNull()) {
             this->calculationsStopCallback();
@@ -563,7 +735,9 @@ RoutingProtocol::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
         {
           if (dst == iface.GetBroadcast () || dst.IsBroadcast ())
             {
-              if (m_dpd.IsDuplicate (p, header))
+              bool duplicate = m_enableDpdPrefilter ? m_dpdPrefilter.IsDuplicate (p, header)
+                                                    : m_dpd.IsDuplicate (p, header);
+              if (duplicate)
                 {
                   NS_LOG_DEBUG ("Duplicated packet " << p->GetUid () << " from " << origin << ". Drop.");
 
@@ -684,10 +858,35 @@ RoutingProtocol::Forwarding (Ptr<const Packet> p, const Ipv4Header & header,
   }
 
   NS_LOG_FUNCTION (this);
+  if (!m_attack->OnForward (p, header))
+    {
+      NS_LOG_DEBUG ("Drop packet " << p->GetUid () << " by attack behavior");
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return false;
+    }
   Ipv4Address dst = header.GetDestination ();
   Ipv4Address origin = header.GetSource ();
   m_routingTable.Purge ();
   RoutingTableEntry toDst;
+  if (m_enableMultipath && !m_routingTable.LookupValidRoute (dst, toDst))
+    {
+      FailOver (dst, Ipv4Address ());
+    }
+  if (m_localRepair.find (dst) != m_localRepair.end () && !m_routingTable.LookupValidRoute (dst, toDst))
+    {
+      // Hold the packet until the local repair ends
+      NS_LOG_LOGIC ("Route to " << dst << " is under local repair, queue packet " << p->GetUid ());
+      QueueEntry newEntry (p, header, ucb, ecb);
+      newEntry.SetForwarded (true);
+      m_queue.Enqueue (newEntry);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return true;
+    }
   if (m_routingTable.LookupRoute (dst, toDst))
     {
       if (toDst.GetFlag () == VALID)
@@ -716,7 +915,15 @@ RoutingProtocol::Forwarding (Ptr<const Packet> p, const Ipv4Header & header,
           m_nb.Update (route->GetGateway (), m_activeRouteTimeout);
           m_nb.Update (toOrigin.GetNextHop (), m_activeRouteTimeout);
 
-          ucb (route, p, header);
+          route = m_routePolicy.Apply (route);
+          if (m_attack->OnDataSend (p, header, route->GetGateway ()))
+            {
+              NS_LOG_DEBUG ("Packet " << p->GetUid () << " taken by attack behavior");
+            }
+          else
+            {
+              ucb (route, p, header);
+            }
 
           if (!this->calculationsStopCallback.IsNull()) {
             this->calculationsStopCallback();
@@ -753,6 +960,27 @@ RoutingProtocol::SetIpv4 (Ptr<Ipv4> ipv4)
 
   m_ipv4 = ipv4;
 
+  // Attributes are set by now; the behavior is made here rather than on initialization,
+  // so that AssignStreams reaches it
+  if (m_isBlackHole)
+    {
+      m_attackBehavior = CreateObject<BlackHoleAttack> ();
+    }
+  else if (m_attackFactory.GetTypeId () != AttackBehavior::GetTypeId ())
+    {
+      m_attackBehavior = m_attackFactory.Create<AttackBehavior> ();
+    }
+  m_attack = m_attackBehavior;
+  if (m_attackStart.IsStrictlyPositive ())
+    {
+      m_attackActive = false;
+      m_attack = m_honest;
+    }
+  if (m_attackStart.IsStrictlyPositive () || m_attackStop.IsStrictlyPositive ())
+    {
+      ScheduleAttack (m_attackStart, m_attackStop);
+    }
+
   // Create lo route. It is asserted that the only one interface up for now is loopback
   NS_ASSERT (m_ipv4->GetNInterfaces () == 1 && m_ipv4->GetAddress (0, 0).GetLocal () == Ipv4Address ("127.0.0.1"));
   m_lo = m_ipv4->GetNetDevice (0);
@@ -855,6 +1083,7 @@ RoutingProtocol::NotifyInterfaceDown (uint32_t i)
   }
 
   NS_LOG_FUNCTION (this << m_ipv4->GetAddress (i, 0).GetLocal ());
+  m_helloTemplates.clear ();
 
   // Disable layer 2 link state monitoring (if possible)
   Ptr<Ipv4L3Protocol> l3 = m_ipv4->GetObject<Ipv4L3Protocol> ();
@@ -886,7 +1115,7 @@ RoutingProtocol::NotifyInterfaceDown (uint32_t i)
   if (m_socketAddresses.empty ())
     {
       NS_LOG_LOGIC ("No aodv interfaces");
-      m_htimer.Cancel ();
+      m_timers.Cancel (m_htimer);
       m_nb.Clear ();
       m_routingTable.Clear ();
       if (!this->calculationsStopCallback.IsNull()) {
@@ -980,6 +1209,7 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
   Ptr<Socket> socket = FindSocketWithInterfaceAddress (address);
   if (socket)
     {
+      m_helloTemplates.clear ();
       m_routingTable.DeleteAllRoutesFromInterface (address);
       socket->Close ();
       m_socketAddresses.erase (socket);
@@ -1027,7 +1257,7 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
       if (m_socketAddresses.empty ())
         {
           NS_LOG_LOGIC ("No aodv interfaces");
-          m_htimer.Cancel ();
+          m_timers.Cancel (m_htimer);
           m_nb.Clear ();
           m_routingTable.Clear ();
           if (!this->calculationsStopCallback.IsNull()) {
@@ -1138,20 +1368,36 @@ RoutingProtocol::SendRequest (Ipv4Address dst)
 
   NS_LOG_FUNCTION ( this << dst);
   // A node SHOULD NOT originate more than RREQ_RATELIMIT RREQ messages per second.
-  if (m_rreqCount == m_rreqRateLimit)
+  RefillRreqTokens ();
+  if (!m_pendingRreqs.empty () || m_rreqTokens < 1)
     {
-      Simulator::Schedule (m_rreqRateLimitTimer.GetDelayLeft () + MicroSeconds (100),
-                           &RoutingProtocol::SendRequest, this, dst);
+      if (m_pendingRreqSet.insert (dst).second)
+        {
+          m_pendingRreqs.push_back (dst);
+        }
+      ScheduleRreqRelease ();
 
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
       }
       return;
     }
-  else
-    {
-      m_rreqCount++;
-    }
+  m_rreqTokens -= 1;
+  DoSendRequest (dst);
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::DoSendRequest (Ipv4Address dst)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION ( this << dst);
   // Create RREQ header
   RreqHeader rreqHeader;
   rreqHeader.SetDst (dst);
@@ -1173,6 +1419,12 @@ RoutingProtocol::SendRequest (Ipv4Address dst)
               ttl = m_netDiameter;
             }
         }
+      std::map<Ipv4Address, LocalRepair>::const_iterator repair = m_localRepair.find (dst);
+      if (repair != m_localRepair.end ())
+        {
+          // Local repair searches a single bounded ring
+          ttl = repair->second.m_ttl;
+        }
       if (ttl == m_netDiameter)
         {
           rt.IncrementRreqCnt ();
@@ -1249,7 +1501,7 @@ RoutingProtocol::SendRequest (Ipv4Address dst)
         }
       NS_LOG_DEBUG ("Send RREQ with id " << rreqHeader.GetId () << " to socket");
       m_lastBcastTime = Simulator::Now ();
-      Simulator::Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), &RoutingProtocol::SendTo, this, socket, packet, destination);
+      m_timers.Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), std::bind (&RoutingProtocol::SendTo, this, socket, packet, destination));
     }
   ScheduleRreqRetry (dst);
 
@@ -1258,6 +1510,35 @@ RoutingProtocol::SendRequest (Ipv4Address dst)
   }
 }
 
+void
+RoutingProtocol::ScheduleRreqFlood ()
+{
+  m_timers.Cancel (m_rreqFloodTimer);
+  Time interval = m_attack->OnRreqFloodSchedule ();
+  if (interval.IsStrictlyPositive ())
+    {
+      m_rreqFloodTimer = m_timers.Schedule (interval, std::bind (&RoutingProtocol::RreqFloodTimerExpire, this));
+    }
+}
+
+void
+RoutingProtocol::RreqFloodTimerExpire ()
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  Ipv4Address dst = m_attack->OnRreqFloodDestination ();
+  NS_LOG_FUNCTION (this << dst);
+  // A flooding node does not keep to the RREQ rate limit
+  DoSendRequest (dst);
+  ScheduleRreqFlood ();
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
 void
 RoutingProtocol::SendTo (Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination)
 {
@@ -1265,7 +1546,10 @@ RoutingProtocol::SendTo (Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address des
     this->calculationsStartCallback();
   }
 
-  socket->SendTo (packet, 0, InetSocketAddress (destination, AODV_PORT));
+  if (!m_attack->OnControlSend (packet, destination))
+    {
+      socket->SendTo (packet, 0, InetSocketAddress (destination, AODV_PORT));
+    }
 
   if (!this->calculationsStopCallback.IsNull()) {
     this->calculationsStopCallback();
@@ -1279,14 +1563,6 @@ RoutingProtocol::ScheduleRreqRetry (Ipv4Address dst)
   }
 
   NS_LOG_FUNCTION (this << dst);
-  if (m_addressReqTimer.find (dst) == m_addressReqTimer.end ())
-    {
-      Timer timer (Timer::CANCEL_ON_DESTROY);
-      m_addressReqTimer[dst] = timer;
-    }
-  m_addressReqTimer[dst].SetFunction (&RoutingProtocol::RouteRequestTimerExpire, this);
-  m_addressReqTimer[dst].Remove ();
-  m_addressReqTimer[dst].SetArguments (dst);
   RoutingTableEntry rt;
   m_routingTable.LookupRoute (dst, rt);
   Time retry;
@@ -1301,7 +1577,7 @@ RoutingProtocol::ScheduleRreqRetry (Ipv4Address dst)
       NS_LOG_LOGIC ("Applying binary exponential backoff factor " << backoffFactor);
       retry = m_netTraversalTime * (1 << backoffFactor);
     }
-  m_addressReqTimer[dst].Schedule (retry);
+  m_addressReqTimer.Schedule (dst, retry, std::bind (&RoutingProtocol::RouteRequestTimerExpire, this, dst));
   NS_LOG_LOGIC ("Scheduled RREQ retry in " << retry.GetSeconds () << " seconds");
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -1337,27 +1613,40 @@ RoutingProtocol::RecvAodv (Ptr<Socket> socket)
     }
   NS_LOG_DEBUG ("AODV node " << this << " received a AODV packet from " << sender << " to " << receiver);
 
+  RecvAodvPacket (packet, sender, receiver);
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::RecvAodvPacket (Ptr<Packet> packet, Ipv4Address sender, Ipv4Address receiver)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
   UpdateRouteToNeighbor (sender, receiver);
-  TypeHeader tHeader (AODVTYPE_RREQ);
-  packet->RemoveHeader (tHeader);
-  if (!tHeader.IsValid ())
+  AodvPacketView view (packet);
+  if (!view.IsValid ())
     {
-      NS_LOG_DEBUG ("AODV message " << packet->GetUid () << " with unknown type received: " << tHeader.Get () << ". Drop");
+      NS_LOG_DEBUG ("AODV message " << packet->GetUid () << " with unknown type received: " << uint32_t (view.GetTypeByte ()) << ". Drop");
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
       }
       return; // drop
     }
-  switch (tHeader.Get ())
+  switch (view.GetType ())
     {
     case AODVTYPE_RREQ:
       {
-        RecvRequest (packet, receiver, sender);
+        RecvRequest (packet, view, receiver, sender);
         break;
       }
     case AODVTYPE_RREP:
       {
-        RecvReply (packet, receiver, sender);
+        RecvReply (packet, view, receiver, sender);
         break;
       }
     case AODVTYPE_RERR:
@@ -1447,15 +1736,13 @@ RoutingProtocol::UpdateRouteToNeighbor (Ipv4Address sender, Ipv4Address receiver
 }
 
 void
-RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
+RoutingProtocol::RecvRequest (Ptr<Packet> p, AodvPacketView const & view, Ipv4Address receiver, Ipv4Address src)
 {
   if (!this->calculationsStartCallback.IsNull()) {
     this->calculationsStartCallback();
   }
 
   NS_LOG_FUNCTION (this);
-  RreqHeader rreqHeader;
-  p->RemoveHeader (rreqHeader);
 
   // A node ignores all RREQs received from any node in its blacklist
   RoutingTableEntry toPrev;
@@ -1471,8 +1758,8 @@ RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address s
         }
     }
 
-  uint32_t id = rreqHeader.GetId ();
-  Ipv4Address origin = rreqHeader.GetOrigin ();
+  uint32_t id = view.GetRreqId ();
+  Ipv4Address origin = view.GetRreqOrigin ();
 
   /*
    *  Node checks to determine whether it has received a RREQ with the same Originator IP Address and RREQ ID.
@@ -1481,6 +1768,19 @@ RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address s
   if (m_rreqIdCache.IsDuplicate (origin, id))
     {
       NS_LOG_DEBUG ("Ignoring RREQ due to duplicate");
+      if (m_enableMultipath)
+        {
+          // A copy that came over another neighbor is an alternate reverse route to the originator
+          uint16_t hop = view.GetRreqHopCount () + 1;
+          AlternatePath path;
+          path.m_nextHop = src;
+          path.m_device = m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (receiver));
+          path.m_iface = m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0);
+          path.m_hops = hop;
+          path.m_seqNo = view.GetRreqOriginSeqno ();
+          path.m_expire = Simulator::Now () + 2 * m_netTraversalTime - 2 * hop * m_nodeTraversalTime;
+          AddAlternatePath (origin, path);
+        }
 
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
@@ -1488,6 +1788,11 @@ RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address s
       return;
     }
 
+  TypeHeader tHeader;
+  p->RemoveHeader (tHeader);
+  RreqHeader rreqHeader;
+  p->RemoveHeader (rreqHeader);
+
   // Increment RREQ hop count
   uint8_t hop = rreqHeader.GetHopCount () + 1;
   rreqHeader.SetHopCount (hop);
@@ -1576,6 +1881,21 @@ RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address s
       }
       return;
     }
+  if (m_attack->OnRreqReceived (rreqHeader, src))
+    {
+      // Answer as if the destination were a neighbor
+      Ptr<NetDevice> dev = m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (receiver));
+      RoutingTableEntry falseToDst (/*device=*/ dev, /*dst=*/ rreqHeader.GetDst (), /*validSeqNo=*/ true,
+                                               /*seqNo=*/ rreqHeader.GetDstSeqno (),
+                                               /*iface=*/ m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0),
+                                               /*hops=*/ 1, /*nextHop=*/ rreqHeader.GetDst (), /*lifeTime=*/ m_activeRouteTimeout);
+      m_routingTable.LookupRoute (origin, toOrigin);
+      SendReplyByIntermediateNode (falseToDst, toOrigin, false);
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
   /*
    * (ii) or it has an active route to the destination, the destination sequence number in the node's existing route table entry for the destination
    *      is valid and greater than or equal to the Destination Sequence Number of the RREQ, and the "destination only" flag is NOT set.
@@ -1652,7 +1972,7 @@ RoutingProtocol::RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address s
           destination = iface.GetBroadcast ();
         }
       m_lastBcastTime = Simulator::Now ();
-      Simulator::Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), &RoutingProtocol::SendTo, this, socket, packet, destination);
+      m_timers.Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), std::bind (&RoutingProtocol::SendTo, this, socket, packet, destination));
 
     }
 
@@ -1705,6 +2025,7 @@ RoutingProtocol::SendReplyByIntermediateNode (RoutingTableEntry & toDst, Routing
   NS_LOG_FUNCTION (this);
   RrepHeader rrepHeader (/*prefix size=*/ 0, /*hops=*/ toDst.GetHop (), /*dst=*/ toDst.GetDestination (), /*dst seqno=*/ toDst.GetSeqNo (),
                                           /*origin=*/ toOrigin.GetDestination (), /*lifetime=*/ toDst.GetLifeTime ());
+  m_attack->OnRrepBuild (rrepHeader);
   /* If the node we received a RREQ for is a neighbor we are
    * probably facing a unidirectional link... Better request a RREP-ack
    */
@@ -1785,31 +2106,34 @@ RoutingProtocol::SendReplyAck (Ipv4Address neighbor)
 }
 
 void
-RoutingProtocol::RecvReply (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
+RoutingProtocol::RecvReply (Ptr<Packet> p, AodvPacketView const & view, Ipv4Address receiver, Ipv4Address sender)
 {
   if (!this->calculationsStartCallback.IsNull()) {
     this->calculationsStartCallback();
   }
 
   NS_LOG_FUNCTION (this << " src " << sender);
-  RrepHeader rrepHeader;
-  p->RemoveHeader (rrepHeader);
-  Ipv4Address dst = rrepHeader.GetDst ();
-  NS_LOG_LOGIC ("RREP destination " << dst << " RREP origin " << rrepHeader.GetOrigin ());
-
-  uint8_t hop = rrepHeader.GetHopCount () + 1;
-  rrepHeader.SetHopCount (hop);
+  NS_LOG_LOGIC ("RREP destination " << view.GetRrepDst () << " RREP origin " << view.GetRrepOrigin ());
 
   // If RREP is Hello message
-  if (dst == rrepHeader.GetOrigin ())
+  if (view.IsHello ())
     {
-      ProcessHello (rrepHeader, receiver);
+      ProcessHello (view, receiver);
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
       }
       return;
     }
 
+  TypeHeader tHeader;
+  p->RemoveHeader (tHeader);
+  RrepHeader rrepHeader;
+  p->RemoveHeader (rrepHeader);
+  Ipv4Address dst = rrepHeader.GetDst ();
+
+  uint8_t hop = rrepHeader.GetHopCount () + 1;
+  rrepHeader.SetHopCount (hop);
+
   /*
    * If the route table entry to the destination is created or updated, then the following actions occur:
    * -  the route is marked as active,
@@ -1850,7 +2174,34 @@ RoutingProtocol::RecvReply (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sen
           // (iv)  the sequence numbers are the same, and the New Hop Count is smaller than the hop count in route table entry.
           else if ((rrepHeader.GetDstSeqno () == toDst.GetSeqNo ()) && (hop < toDst.GetHop ()))
             {
-              m_routingTable.Update (newEntry);
+              if (m_enableMultipath)
+                {
+                  // The replaced route stays fresh, keep it as an alternate
+                  AlternatePath path;
+                  path.m_nextHop = toDst.GetNextHop ();
+                  path.m_device = toDst.GetOutputDevice ();
+                  path.m_iface = toDst.GetInterface ();
+                  path.m_hops = toDst.GetHop ();
+                  path.m_seqNo = toDst.GetSeqNo ();
+                  path.m_expire = Simulator::Now () + toDst.GetLifeTime ();
+                  m_routingTable.Update (newEntry);
+                  AddAlternatePath (dst, path);
+                }
+              else
+                {
+                  m_routingTable.Update (newEntry);
+                }
+            }
+          else if (m_enableMultipath && (rrepHeader.GetDstSeqno () == toDst.GetSeqNo ()))
+            {
+              AlternatePath path;
+              path.m_nextHop = sender;
+              path.m_device = dev;
+              path.m_iface = newEntry.GetInterface ();
+              path.m_hops = hop;
+              path.m_seqNo = rrepHeader.GetDstSeqno ();
+              path.m_expire = Simulator::Now () + rrepHeader.GetLifeTime ();
+              AddAlternatePath (dst, path);
             }
         }
     }
@@ -1872,8 +2223,11 @@ RoutingProtocol::RecvReply (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sen
       if (toDst.GetFlag () == IN_SEARCH)
         {
           m_routingTable.Update (newEntry);
-          m_addressReqTimer[dst].Remove ();
-          m_addressReqTimer.erase (dst);
+          m_addressReqTimer.Cancel (dst);
+        }
+      if (m_localRepair.find (dst) != m_localRepair.end ())
+        {
+          FinishLocalRepair (dst, true);
         }
       m_routingTable.LookupRoute (dst, toDst);
       SendPacketFromQueue (dst, toDst.GetRoute ());
@@ -1963,7 +2317,7 @@ RoutingProtocol::RecvReplyAck (Ipv4Address neighbor)
 }
 
 void
-RoutingProtocol::ProcessHello (RrepHeader const & rrepHeader, Ipv4Address receiver )
+RoutingProtocol::ProcessHello (AodvPacketView const & hello, Ipv4Address receiver )
 {
   if (!this->calculationsStartCallback.IsNull()) {
     this->calculationsStartCallback();
@@ -1971,40 +2325,40 @@ RoutingProtocol::ProcessHello (RrepHeader const & rrepHeader, Ipv4Address receiv
 
   if (this->m_enableHelloFloodPrevention)
   {
-    Fsm& fsm = Fsms::Get(rrepHeader.GetDst());
+    Fsm& fsm = Fsms::Get(hello.GetRrepDst ());
     fsm.ProcessHello();
   }
 
-  NS_LOG_FUNCTION (this << "from " << rrepHeader.GetDst ());
+  NS_LOG_FUNCTION (this << "from " << hello.GetRrepDst ());
   /*
    *  Whenever a node receives a Hello message from a neighbor, the node
    * SHOULD make sure that it has an active route to the neighbor, and
    * create one if necessary.
    */
   RoutingTableEntry toNeighbor;
-  if (!m_routingTable.LookupRoute (rrepHeader.GetDst (), toNeighbor))
+  if (!m_routingTable.LookupRoute (hello.GetRrepDst (), toNeighbor))
     {
       Ptr<NetDevice> dev = m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (receiver));
-      RoutingTableEntry newEntry (/*device=*/ dev, /*dst=*/ rrepHeader.GetDst (), /*validSeqNo=*/ true, /*seqno=*/ rrepHeader.GetDstSeqno (),
+      RoutingTableEntry newEntry (/*device=*/ dev, /*dst=*/ hello.GetRrepDst (), /*validSeqNo=*/ true, /*seqno=*/ hello.GetRrepDstSeqno (),
                                               /*iface=*/ m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0),
-                                              /*hop=*/ 1, /*nextHop=*/ rrepHeader.GetDst (), /*lifeTime=*/ rrepHeader.GetLifeTime ());
+                                              /*hop=*/ 1, /*nextHop=*/ hello.GetRrepDst (), /*lifeTime=*/ hello.GetRrepLifeTime ());
       m_routingTable.AddRoute (newEntry);
     }
   else
     {
       toNeighbor.SetLifeTime (std::max (Time (m_allowedHelloLoss * m_helloInterval), toNeighbor.GetLifeTime ()));
-      toNeighbor.SetSeqNo (rrepHeader.GetDstSeqno ());
+      toNeighbor.SetSeqNo (hello.GetRrepDstSeqno ());
       toNeighbor.SetValidSeqNo (true);
       toNeighbor.SetFlag (VALID);
       toNeighbor.SetOutputDevice (m_ipv4->GetNetDevice (m_ipv4->GetInterfaceForAddress (receiver)));
       toNeighbor.SetInterface (m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0));
       toNeighbor.SetHop (1);
-      toNeighbor.SetNextHop (rrepHeader.GetDst ());
+      toNeighbor.SetNextHop (hello.GetRrepDst ());
       m_routingTable.Update (toNeighbor);
     }
   if (m_enableHello)
     {
-      m_nb.Update (rrepHeader.GetDst (), Time (m_allowedHelloLoss * m_helloInterval));
+      m_nb.Update (hello.GetRrepDst (), Time (m_allowedHelloLoss * m_helloInterval));
     }
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -2020,6 +2374,8 @@ RoutingProtocol::RecvError (Ptr<Packet> p, Ipv4Address src )
   }
 
   NS_LOG_FUNCTION (this << " from " << src);
+  TypeHeader tHeader;
+  p->RemoveHeader (tHeader);
   RerrHeader rerrHeader;
   p->RemoveHeader (rerrHeader);
   std::map<Ipv4Address, uint32_t> dstWithNextHopSrc;
@@ -2037,8 +2393,38 @@ RoutingProtocol::RecvError (Ptr<Packet> p, Ipv4Address src )
             }
         }
     }
+  if (m_enableMultipath)
+    {
+      for (std::map<Ipv4Address, uint32_t>::iterator i = unreachable.begin (); i != unreachable.end (); )
+        {
+          if (FailOver (i->first, src))
+            {
+              unreachable.erase (i++);
+            }
+          else
+            {
+              ++i;
+            }
+        }
+    }
 
   std::vector<Ipv4Address> precursors;
+  if (m_rerrAggregationWindow.IsStrictlyPositive ())
+    {
+      for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin (); i != unreachable.end (); ++i)
+        {
+          RoutingTableEntry toDst;
+          m_routingTable.LookupRoute (i->first, toDst);
+          toDst.GetPrecursors (precursors);
+        }
+      QueueRerr (unreachable, precursors, false);
+      m_routingTable.InvalidateRoutesWithDst (unreachable);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
   for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin ();
        i != unreachable.end (); )
     {
@@ -2091,9 +2477,22 @@ RoutingProtocol::RouteRequestTimerExpire (Ipv4Address dst)
   RoutingTableEntry toDst;
   if (m_routingTable.LookupValidRoute (dst, toDst))
     {
+      if (m_localRepair.find (dst) != m_localRepair.end ())
+        {
+          FinishLocalRepair (dst, true);
+        }
       SendPacketFromQueue (dst, toDst.GetRoute ());
       NS_LOG_LOGIC ("route to " << dst << " found");
 
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+  if (m_localRepair.find (dst) != m_localRepair.end ())
+    {
+      FinishLocalRepair (dst, false);
+
       if (!this->calculationsStopCallback.IsNull()) {
         this->calculationsStopCallback();
       }
@@ -2107,7 +2506,7 @@ RoutingProtocol::RouteRequestTimerExpire (Ipv4Address dst)
   if (toDst.GetRreqCnt () == m_rreqRetries)
     {
       NS_LOG_LOGIC ("route discovery to " << dst << " has been attempted RreqRetries (" << m_rreqRetries << ") times with ttl " << m_netDiameter);
-      m_addressReqTimer.erase (dst);
+      m_addressReqTimer.Cancel (dst);
       m_routingTable.DeleteRoute (dst);
       NS_LOG_DEBUG ("Route not found. Drop all packets with dst " << dst);
       m_queue.DropPacketWithDst (dst);
@@ -2126,7 +2525,7 @@ RoutingProtocol::RouteRequestTimerExpire (Ipv4Address dst)
   else
     {
       NS_LOG_DEBUG ("Route down. Stop search. Drop packet with destination " << dst);
-      m_addressReqTimer.erase (dst);
+      m_addressReqTimer.Cancel (dst);
       m_routingTable.DeleteRoute (dst);
       m_queue.DropPacketWithDst (dst);
     }
@@ -2154,9 +2553,10 @@ RoutingProtocol::HelloTimerExpire ()
     {
       SendHello ();
     }
-  m_htimer.Cancel ();
-  Time diff = m_helloInterval - offset;
-  m_htimer.Schedule (std::max (Time (Seconds (0)), diff));
+  m_timers.Cancel (m_htimer);
+  Time diff = m_attack->OnHelloSchedule (m_helloInterval) - offset;
+  m_htimer = m_timers.Schedule (std::max (Time (Seconds (0)), diff),
+                                std::bind (&RoutingProtocol::HelloTimerExpire, this));
   m_lastBcastTime = Time (Seconds (0));
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -2165,15 +2565,45 @@ RoutingProtocol::HelloTimerExpire ()
 }
 
 void
-RoutingProtocol::RreqRateLimitTimerExpire ()
+RoutingProtocol::RefillRreqTokens ()
+{
+  Time now = Simulator::Now ();
+  m_rreqTokens = std::min<double> (m_rreqRateLimit,
+                                   m_rreqTokens + (now - m_rreqTokensUpdate).GetSeconds () * m_rreqRateLimit);
+  m_rreqTokensUpdate = now;
+}
+
+void
+RoutingProtocol::ScheduleRreqRelease ()
+{
+  if (m_pendingRreqs.empty () || m_rreqRateLimit == 0 || m_timers.IsRunning (m_rreqReleaseTimer))
+    {
+      return;
+    }
+  // Round up to the next nanosecond so the token has fully accrued when the timer fires
+  double wait = std::max (0.0, (1 - m_rreqTokens) / m_rreqRateLimit);
+  m_rreqReleaseTimer = m_timers.Schedule (NanoSeconds (static_cast<uint64_t> (std::ceil (wait * 1e9))),
+                                          std::bind (&RoutingProtocol::ReleaseRreqs, this));
+}
+
+void
+RoutingProtocol::ReleaseRreqs ()
 {
   if (!this->calculationsStartCallback.IsNull()) {
     this->calculationsStartCallback();
   }
 
-  NS_LOG_FUNCTION (this);
-  m_rreqCount = 0;
-  m_rreqRateLimitTimer.Schedule (Seconds (1));
+  NS_LOG_FUNCTION (this << m_pendingRreqs.size ());
+  RefillRreqTokens ();
+  while (!m_pendingRreqs.empty () && m_rreqTokens >= 1)
+    {
+      Ipv4Address dst = m_pendingRreqs.front ();
+      m_pendingRreqs.pop_front ();
+      m_pendingRreqSet.erase (dst);
+      m_rreqTokens -= 1;
+      DoSendRequest (dst);
+    }
+  ScheduleRreqRelease ();
 
   if (!this->calculationsStopCallback.IsNull()) {
     this->calculationsStopCallback();
@@ -2189,7 +2619,8 @@ RoutingProtocol::RerrRateLimitTimerExpire ()
 
   NS_LOG_FUNCTION (this);
   m_rerrCount = 0;
-  m_rerrRateLimitTimer.Schedule (Seconds (1));
+  m_rerrRateLimitTimer = m_timers.Schedule (Seconds (1),
+                                             std::bind (&RoutingProtocol::RerrRateLimitTimerExpire, this));
 
   if (!this->calculationsStopCallback.IsNull()) {
     this->calculationsStopCallback();
@@ -2228,28 +2659,29 @@ RoutingProtocol::SendHello ()
   for (std::map<Ptr<Socket>, Ipv4InterfaceAddress>::const_iterator j = m_socketAddresses.begin (); j != m_socketAddresses.end (); ++j)
     {
       Ptr<Socket> socket = j->first;
-      Ipv4InterfaceAddress iface = j->second;
-      RrepHeader helloHeader (/*prefix size=*/ 0, /*hops=*/ 0, /*dst=*/ iface.GetLocal (), /*dst seqno=*/ m_seqNo,
-                                               /*origin=*/ iface.GetLocal (),/*lifetime=*/ Time (m_allowedHelloLoss * m_helloInterval));
-      Ptr<Packet> packet = Create<Packet> ();
+      std::map<Ptr<Socket>, HelloTemplate>::iterator hello = m_helloTemplates.find (socket);
+      if (hello == m_helloTemplates.end ())
+        {
+          Ipv4InterfaceAddress iface = j->second;
+          // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
+          Ipv4Address destination;
+          if (iface.GetMask () == Ipv4Mask::GetOnes ())
+            {
+              destination = Ipv4Address ("255.255.255.255");
+            }
+          else
+            {
+              destination = iface.GetBroadcast ();
+            }
+          hello = m_helloTemplates.insert (std::make_pair (socket, HelloTemplate (iface.GetLocal (), destination))).first;
+        }
+      hello->second.SetOrigin (m_attack->OnHelloOrigin (j->second.GetLocal ()));
+      Ptr<Packet> packet = hello->second.Make (m_seqNo, Time (m_allowedHelloLoss * m_helloInterval));
       SocketIpTtlTag tag;
       tag.SetTtl (1);
       packet->AddPacketTag (tag);
-      packet->AddHeader (helloHeader);
-      TypeHeader tHeader (AODVTYPE_RREP);
-      packet->AddHeader (tHeader);
-      // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
-      Ipv4Address destination;
-      if (iface.GetMask () == Ipv4Mask::GetOnes ())
-        {
-          destination = Ipv4Address ("255.255.255.255");
-        }
-      else
-        {
-          destination = iface.GetBroadcast ();
-        }
       Time jitter = Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10)));
-      Simulator::Schedule (jitter, &RoutingProtocol::SendTo, this, socket, packet, destination);
+      m_timers.Schedule (jitter, std::bind (&RoutingProtocol::SendTo, this, socket, packet, hello->second.GetDestination ()));
     }
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -2283,9 +2715,31 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst, Ptr<Ipv4Route> route)
         }
       UnicastForwardCallback ucb = queueEntry.GetUnicastForwardCallback ();
       Ipv4Header header = queueEntry.GetIpv4Header ();
-      header.SetSource (route->GetSource ());
+      if (queueEntry.IsForwarded ())
+        {
+          // Held during local repair: keep the source and TTL of the original sender
+          Ptr<Ipv4Route> forwardRoute = m_routePolicy.Apply (route);
+          if (m_attack->OnDataSend (p, header, forwardRoute->GetGateway ()))
+            {
+              NS_LOG_DEBUG ("Packet " << p->GetUid () << " taken by attack behavior");
+            }
+          else
+            {
+              ucb (forwardRoute, p, header);
+            }
+          continue;
+        }
+      header.SetSource (route->GetSource ());
       header.SetTtl (header.GetTtl () + 1); // compensate extra TTL decrement by fake loopback routing
-      ucb (route, p, header);
+      Ptr<Ipv4Route> outputRoute = m_attack->OnRouteOutput (header, m_routePolicy.Apply (route));
+      if (m_attack->OnDataSend (p, header, outputRoute->GetGateway ()))
+        {
+          NS_LOG_DEBUG ("Packet " << p->GetUid () << " taken by attack behavior");
+        }
+      else
+        {
+          ucb (outputRoute, p, header);
+        }
     }
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -2314,8 +2768,56 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop (Ipv4Address nextHop)
       return;
     }
   toNextHop.GetPrecursors (precursors);
-  rerrHeader.AddUnDestination (nextHop, toNextHop.GetSeqNo ());
   m_routingTable.GetListOfDestinationWithNextHop (nextHop, unreachable);
+  if (m_enableMultipath)
+    {
+      // Destinations with an alternate path are switched over instead of reported
+      m_alternatePaths.RemoveNextHop (nextHop);
+      for (std::map<Ipv4Address, uint32_t>::iterator i = unreachable.begin (); i != unreachable.end (); )
+        {
+          if (FailOver (i->first, nextHop))
+            {
+              unreachable.erase (i++);
+            }
+          else
+            {
+              ++i;
+            }
+        }
+    }
+  if (m_enableLocalRepair)
+    {
+      // Destinations under local repair are reported only if the repair fails
+      for (std::map<Ipv4Address, uint32_t>::iterator i = unreachable.begin (); i != unreachable.end (); )
+        {
+          if (i->first != nextHop && StartLocalRepair (i->first))
+            {
+              unreachable.erase (i++);
+            }
+          else
+            {
+              ++i;
+            }
+        }
+    }
+  if (m_rerrAggregationWindow.IsStrictlyPositive ())
+    {
+      for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin (); i != unreachable.end (); ++i)
+        {
+          RoutingTableEntry toDst;
+          m_routingTable.LookupRoute (i->first, toDst);
+          toDst.GetPrecursors (precursors);
+        }
+      unreachable.insert (std::make_pair (nextHop, toNextHop.GetSeqNo ()));
+      QueueRerr (unreachable, precursors, false);
+      m_routingTable.InvalidateRoutesWithDst (unreachable);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+  rerrHeader.AddUnDestination (nextHop, toNextHop.GetSeqNo ());
   for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin (); i
        != unreachable.end (); )
     {
@@ -2368,14 +2870,33 @@ RoutingProtocol::SendRerrWhenNoRouteToForward (Ipv4Address dst,
   }
 
   NS_LOG_FUNCTION (this);
+  RoutingTableEntry toOrigin;
+  if (m_rerrAggregationWindow.IsStrictlyPositive ())
+    {
+      std::map<Ipv4Address, uint32_t> unreachable;
+      unreachable.insert (std::make_pair (dst, dstSeqNo));
+      std::vector<Ipv4Address> precursors;
+      bool broadcast = true;
+      if (m_routingTable.LookupValidRoute (origin, toOrigin))
+        {
+          precursors.push_back (toOrigin.GetNextHop ());
+          broadcast = false;
+        }
+      QueueRerr (unreachable, precursors, broadcast);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
   // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
   if (m_rerrCount == m_rerrRateLimit)
     {
       // Just make sure that the RerrRateLimit timer is running and will expire
-      NS_ASSERT (m_rerrRateLimitTimer.IsRunning ());
+      NS_ASSERT (m_timers.IsRunning (m_rerrRateLimitTimer));
       // discard the packet and return
       NS_LOG_LOGIC ("RerrRateLimit reached at " << Simulator::Now ().GetSeconds () << " with timer delay left "
-                                                << m_rerrRateLimitTimer.GetDelayLeft ().GetSeconds ()
+                                                << m_timers.GetDelayLeft (m_rerrRateLimitTimer).GetSeconds ()
                                                 << "; suppressing RERR");
 
       if (!this->calculationsStopCallback.IsNull()) {
@@ -2385,7 +2906,6 @@ RoutingProtocol::SendRerrWhenNoRouteToForward (Ipv4Address dst,
     }
   RerrHeader rerrHeader;
   rerrHeader.AddUnDestination (dst, dstSeqNo);
-  RoutingTableEntry toOrigin;
   Ptr<Packet> packet = Create<Packet> ();
   SocketIpTtlTag tag;
   tag.SetTtl (1);
@@ -2450,10 +2970,10 @@ RoutingProtocol::SendRerrMessage (Ptr<Packet> packet, std::vector<Ipv4Address> p
   if (m_rerrCount == m_rerrRateLimit)
     {
       // Just make sure that the RerrRateLimit timer is running and will expire
-      NS_ASSERT (m_rerrRateLimitTimer.IsRunning ());
+      NS_ASSERT (m_timers.IsRunning (m_rerrRateLimitTimer));
       // discard the packet and return
       NS_LOG_LOGIC ("RerrRateLimit reached at " << Simulator::Now ().GetSeconds () << " with timer delay left "
-                                                << m_rerrRateLimitTimer.GetDelayLeft ().GetSeconds ()
+                                                << m_timers.GetDelayLeft (m_rerrRateLimitTimer).GetSeconds ()
                                                 << "; suppressing RERR");
 
       if (!this->calculationsStopCallback.IsNull()) {
@@ -2470,7 +2990,7 @@ RoutingProtocol::SendRerrMessage (Ptr<Packet> packet, std::vector<Ipv4Address> p
           Ptr<Socket> socket = FindSocketWithInterfaceAddress (toPrecursor.GetInterface ());
           NS_ASSERT (socket);
           NS_LOG_LOGIC ("one precursor => unicast RERR to " << toPrecursor.GetDestination () << " from " << toPrecursor.GetInterface ().GetLocal ());
-          Simulator::Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), &RoutingProtocol::SendTo, this, socket, packet, precursors.front ());
+          m_timers.Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), std::bind (&RoutingProtocol::SendTo, this, socket, packet, precursors.front ()));
           m_rerrCount++;
         }
 
@@ -2509,7 +3029,327 @@ RoutingProtocol::SendRerrMessage (Ptr<Packet> packet, std::vector<Ipv4Address> p
         {
           destination = i->GetBroadcast ();
         }
-      Simulator::Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), &RoutingProtocol::SendTo, this, socket, p, destination);
+      m_timers.Schedule (Time (MilliSeconds (m_uniformRandomVariable->GetInteger (0, 10))), std::bind (&RoutingProtocol::SendTo, this, socket, p, destination));
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::QueueRerr (std::map<Ipv4Address, uint32_t> const & unreachable, std::vector<Ipv4Address> const & precursors, bool broadcast)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION (this << unreachable.size () << precursors.size () << broadcast);
+  if (unreachable.empty ())
+    {
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+  for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin (); i != unreachable.end (); ++i)
+    {
+      m_rerrUnreachable[i->first] = i->second;
+    }
+  m_rerrPrecursors.insert (precursors.begin (), precursors.end ());
+  m_rerrBroadcast = m_rerrBroadcast || broadcast;
+  if (!m_timers.IsRunning (m_rerrFlushTimer))
+    {
+      m_rerrFlushTimer = m_timers.Schedule (m_rerrAggregationWindow, std::bind (&RoutingProtocol::FlushRerr, this));
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::FlushRerr ()
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION (this << m_rerrUnreachable.size ());
+  std::map<Ipv4Address, uint32_t> unreachable;
+  unreachable.swap (m_rerrUnreachable);
+  std::vector<Ipv4Address> precursors (m_rerrPrecursors.begin (), m_rerrPrecursors.end ());
+  m_rerrPrecursors.clear ();
+  bool broadcast = m_rerrBroadcast;
+  m_rerrBroadcast = false;
+
+  RerrHeader rerrHeader;
+  for (std::map<Ipv4Address, uint32_t>::const_iterator i = unreachable.begin (); i != unreachable.end (); )
+    {
+      if (!rerrHeader.AddUnDestination (i->first, i->second))
+        {
+          NS_LOG_LOGIC ("Send RERR message with maximum size.");
+          SendAggregatedRerr (rerrHeader, precursors, broadcast);
+          rerrHeader.Clear ();
+        }
+      else
+        {
+          ++i;
+        }
+    }
+  if (rerrHeader.GetDestCount () != 0)
+    {
+      SendAggregatedRerr (rerrHeader, precursors, broadcast);
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::SendAggregatedRerr (RerrHeader const & rerrHeader, std::vector<Ipv4Address> const & precursors, bool broadcast)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (rerrHeader.GetDestCount ()) << broadcast);
+  Ptr<Packet> packet = Create<Packet> ();
+  SocketIpTtlTag tag;
+  tag.SetTtl (1);
+  packet->AddPacketTag (tag);
+  packet->AddHeader (rerrHeader);
+  packet->AddHeader (TypeHeader (AODVTYPE_RERR));
+  if (!broadcast)
+    {
+      SendRerrMessage (packet, precursors);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+
+  // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
+  if (m_rerrCount == m_rerrRateLimit)
+    {
+      NS_LOG_LOGIC ("RerrRateLimit reached at " << Simulator::Now ().GetSeconds () << "; suppressing RERR");
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+  for (std::map<Ptr<Socket>, Ipv4InterfaceAddress>::const_iterator i =
+         m_socketAddresses.begin (); i != m_socketAddresses.end (); ++i)
+    {
+      Ptr<Socket> socket = i->first;
+      Ipv4InterfaceAddress iface = i->second;
+      NS_LOG_LOGIC ("Broadcast RERR message from interface " << iface.GetLocal ());
+      // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
+      Ipv4Address destination;
+      if (iface.GetMask () == Ipv4Mask::GetOnes ())
+        {
+          destination = Ipv4Address ("255.255.255.255");
+        }
+      else
+        {
+          destination = iface.GetBroadcast ();
+        }
+      socket->SendTo (packet->Copy (), 0, InetSocketAddress (destination, AODV_PORT));
+    }
+  m_rerrCount++;
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::AddAlternatePath (Ipv4Address dst, AlternatePath const & path)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  RoutingTableEntry rt;
+  if (path.m_expire > Simulator::Now () && !IsMyOwnAddress (dst)
+      && !(m_routingTable.LookupValidRoute (dst, rt) && rt.GetNextHop () == path.m_nextHop))
+    {
+      NS_LOG_LOGIC ("Alternate path to " << dst << " via " << path.m_nextHop << ", " << path.m_hops << " hops");
+      m_alternatePaths.Add (dst, path);
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+bool
+RoutingProtocol::FailOver (Ipv4Address dst, Ipv4Address excluded)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  RoutingTableEntry rt;
+  bool known = m_routingTable.LookupRoute (dst, rt);
+  AlternatePath path;
+  while (m_alternatePaths.Take (dst, excluded, path))
+    {
+      // The next hop must still be a live neighbor and the path must not be older than the route
+      RoutingTableEntry toNextHop;
+      if (!m_routingTable.LookupValidRoute (path.m_nextHop, toNextHop) || toNextHop.GetHop () != 1
+          || toNextHop.IsUnidirectional ()
+          || (known && rt.GetValidSeqNo () && int32_t (path.m_seqNo) - int32_t (rt.GetSeqNo ()) < 0))
+        {
+          continue;
+        }
+      NS_LOG_DEBUG ("Fail over to " << dst << " via " << path.m_nextHop);
+      if (known)
+        {
+          rt.SetNextHop (path.m_nextHop);
+          rt.SetOutputDevice (path.m_device);
+          rt.SetInterface (path.m_iface);
+          rt.SetHop (path.m_hops);
+          rt.SetSeqNo (path.m_seqNo);
+          rt.SetValidSeqNo (true);
+          rt.SetFlag (VALID);
+          rt.SetLifeTime (path.m_expire - Simulator::Now ());
+          m_routingTable.Update (rt);
+        }
+      else
+        {
+          RoutingTableEntry newEntry (/*device=*/ path.m_device, /*dst=*/ dst, /*validSeqNo=*/ true, /*seqno=*/ path.m_seqNo,
+                                                  /*iface=*/ path.m_iface, /*hop=*/ path.m_hops,
+                                                  /*nextHop=*/ path.m_nextHop, /*lifeTime=*/ path.m_expire - Simulator::Now ());
+          m_routingTable.AddRoute (newEntry);
+        }
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return true;
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+  return false;
+}
+
+bool
+RoutingProtocol::StartLocalRepair (Ipv4Address dst)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  RoutingTableEntry toDst;
+  std::vector<Ipv4Address> precursors;
+  if (m_routingTable.LookupRoute (dst, toDst))
+    {
+      toDst.GetPrecursors (precursors);
+    }
+  // Only routes this node forwards on for other nodes are repaired
+  if (precursors.empty () || toDst.GetHop () > m_maxRepairTtl || m_localRepair.find (dst) != m_localRepair.end ())
+    {
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return false;
+    }
+  // RFC 3561 6.12: TTL = max (MIN_REPAIR_TTL, 0.5 * #hops) + LOCAL_ADD_TTL, where MIN_REPAIR_TTL is the last
+  // known hop count to the destination and #hops the hop count to the source of the undeliverable packet.
+  // The repair starts on a link break rather than on a packet, so #hops is taken as the farthest source
+  // whose route goes through a precursor.
+  uint32_t toOriginHops = 0;
+  for (std::vector<Ipv4Address>::const_iterator i = precursors.begin (); i != precursors.end (); ++i)
+    {
+      std::map<Ipv4Address, uint32_t> origins;
+      m_routingTable.GetListOfDestinationWithNextHop (*i, origins);
+      for (std::map<Ipv4Address, uint32_t>::const_iterator j = origins.begin (); j != origins.end (); ++j)
+        {
+          RoutingTableEntry toOrigin;
+          if (m_routingTable.LookupRoute (j->first, toOrigin))
+            {
+              toOriginHops = std::max<uint32_t> (toOriginHops, toOrigin.GetHop ());
+            }
+        }
+    }
+  NS_LOG_DEBUG ("Local repair of route to " << dst << ", " << toDst.GetHop () << " hops");
+  LocalRepair & repair = m_localRepair[dst];
+  repair.m_ttl = std::min<uint32_t> (std::max<uint32_t> (toDst.GetHop (), toOriginHops / 2) + m_localAddTtl, m_netDiameter);
+  repair.m_precursors = precursors;
+
+  // The route is searched with a newer destination sequence number, so a stale route can't answer
+  toDst.SetSeqNo (toDst.GetSeqNo () + 1);
+  toDst.SetFlag (IN_SEARCH);
+  toDst.SetLifeTime (m_pathDiscoveryTime);
+  m_routingTable.Update (toDst);
+  SendRequest (dst);
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+  return true;
+}
+
+void
+RoutingProtocol::FinishLocalRepair (Ipv4Address dst, bool repaired)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  std::map<Ipv4Address, LocalRepair>::iterator i = m_localRepair.find (dst);
+  NS_ASSERT (i != m_localRepair.end ());
+  std::vector<Ipv4Address> precursors;
+  precursors.swap (i->second.m_precursors);
+  m_localRepair.erase (i);
+
+  RoutingTableEntry toDst;
+  m_routingTable.LookupRoute (dst, toDst);
+  if (repaired)
+    {
+      NS_LOG_DEBUG ("Route to " << dst << " repaired via " << toDst.GetNextHop ());
+      for (std::vector<Ipv4Address>::const_iterator j = precursors.begin (); j != precursors.end (); ++j)
+        {
+          toDst.InsertPrecursor (*j);
+        }
+      m_routingTable.Update (toDst);
+
+      if (!this->calculationsStopCallback.IsNull()) {
+        this->calculationsStopCallback();
+      }
+      return;
+    }
+
+  NS_LOG_DEBUG ("Local repair of route to " << dst << " failed. Drop packets and send RERR.");
+  m_addressReqTimer.Cancel (dst);
+  m_queue.DropPacketWithDst (dst);
+  toDst.SetFlag (INVALID);
+  toDst.SetLifeTime (m_deletePeriod);
+  m_routingTable.Update (toDst);
+
+  std::map<Ipv4Address, uint32_t> unreachable;
+  unreachable.insert (std::make_pair (dst, toDst.GetSeqNo ()));
+  if (m_rerrAggregationWindow.IsStrictlyPositive ())
+    {
+      QueueRerr (unreachable, precursors, false);
+    }
+  else
+    {
+      RerrHeader rerrHeader;
+      rerrHeader.AddUnDestination (dst, toDst.GetSeqNo ());
+      TypeHeader typeHeader (AODVTYPE_RERR);
+      Ptr<Packet> packet = Create<Packet> ();
+      SocketIpTtlTag tag;
+      tag.SetTtl (1);
+      packet->AddPacketTag (tag);
+      packet->AddHeader (rerrHeader);
+      packet->AddHeader (typeHeader);
+      SendRerrMessage (packet, precursors);
     }
 
   if (!this->calculationsStopCallback.IsNull()) {
@@ -2582,14 +3422,129 @@ RoutingProtocol::DoInitialize (void)
   uint32_t startTime;
   if (m_enableHello)
     {
-      m_htimer.SetFunction (&RoutingProtocol::HelloTimerExpire, this);
       startTime = m_uniformRandomVariable->GetInteger (0, 100);
       NS_LOG_DEBUG ("Starting at time " << startTime << "ms");
-      m_htimer.Schedule (MilliSeconds (startTime));
+      m_htimer = m_timers.Schedule (MilliSeconds (startTime),
+                                    std::bind (&RoutingProtocol::HelloTimerExpire, this));
+    }
+  if (m_enableDpdPrefilter)
+    {
+      m_dpdPrefilter.Configure (m_dpdPrefilterCapacity, m_dpdPrefilterFpRate);
     }
+  ScheduleRreqFlood ();
   Ipv4RoutingProtocol::DoInitialize ();
 }
 
+void
+RoutingProtocol::SetAttackBehavior (Ptr<AttackBehavior> attack)
+{
+  m_attackBehavior = attack ? attack : m_honest;
+  if (m_attackActive)
+    {
+      m_attack = m_attackBehavior;
+      m_attack->OnActivate ();
+    }
+}
+
+void
+RoutingProtocol::RecvTunneled (Ptr<Packet> packet, Ipv4Address sender)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION (this << packet->GetUid () << sender);
+  if (m_socketAddresses.empty ())
+    {
+      NS_LOG_DEBUG ("No AODV interface to take tunneled packet " << packet->GetUid ());
+    }
+  else
+    {
+      RecvAodvPacket (packet, sender, m_socketAddresses.begin ()->second.GetLocal ());
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::ForwardTunneled (Ptr<Packet> p, Ipv4Header const & header)
+{
+  if (!this->calculationsStartCallback.IsNull()) {
+    this->calculationsStartCallback();
+  }
+
+  NS_LOG_FUNCTION (this << p->GetUid () << header.GetDestination ());
+  // A packet originated by the other end carries the tag of its loopback
+  DeferredRouteOutputTag tag;
+  p->RemovePacketTag (tag);
+  RoutingTableEntry toDst;
+  if (m_ipv4->GetInterfaceForAddress (header.GetDestination ()) >= 0)
+    {
+      // Addressed to this end: deliver through the loopback, where RouteInput hands it up the stack
+      m_ipv4->Send (p, header.GetSource (), header.GetDestination (), header.GetProtocol (),
+                    LoopbackRoute (header, 0));
+    }
+  else if (m_routingTable.LookupValidRoute (header.GetDestination (), toDst))
+    {
+      Ptr<Ipv4Route> route = m_routePolicy.Apply (toDst.GetRoute ());
+      UpdateRouteLifeTime (header.GetDestination (), m_activeRouteTimeout);
+      UpdateRouteLifeTime (route->GetGateway (), m_activeRouteTimeout);
+      m_nb.Update (route->GetGateway (), m_activeRouteTimeout);
+      // The IP header is rebuilt, so the TTL starts over
+      m_ipv4->Send (p, header.GetSource (), header.GetDestination (), header.GetProtocol (), route);
+    }
+  else
+    {
+      NS_LOG_DEBUG ("No route to " << header.GetDestination () << " for tunneled packet " << p->GetUid () << ". Drop");
+    }
+
+  if (!this->calculationsStopCallback.IsNull()) {
+    this->calculationsStopCallback();
+  }
+}
+
+void
+RoutingProtocol::SetAttackActive (bool active)
+{
+  NS_LOG_FUNCTION (this << active);
+  if (active == m_attackActive)
+    {
+      return;
+    }
+  m_attackActive = active;
+  m_attack = active ? m_attackBehavior : m_honest;
+  if (active)
+    {
+      m_attack->OnActivate ();
+    }
+  // Switch to the hello interval of the new behavior at once, e.g. to start a hello flood
+  if (m_timers.IsRunning (m_htimer))
+    {
+      m_timers.Cancel (m_htimer);
+      m_htimer = m_timers.Schedule (m_attack->OnHelloSchedule (m_helloInterval),
+                                    std::bind (&RoutingProtocol::HelloTimerExpire, this));
+    }
+  ScheduleRreqFlood ();
+  m_attackStateChangedTrace (active);
+}
+
+void
+RoutingProtocol::ScheduleAttack (Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << start << stop);
+  Time now = Simulator::Now ();
+  m_timers.Schedule (std::max (start - now, Seconds (0)),
+                     std::bind (&RoutingProtocol::SetAttackActive, this, true));
+  if (stop.IsStrictlyPositive ())
+    {
+      NS_ASSERT (stop >= start);
+      m_timers.Schedule (std::max (stop - now, Seconds (0)),
+                         std::bind (&RoutingProtocol::SetAttackActive, this, false));
+    }
+}
+
 void RoutingProtocol::SetCalculationsStartCallback(Callback<void> callback) {
   calculationsStartCallback = callback;
 }
@@ -31,15 +31,26 @@
 #include "aodv-rtable.h"
 #include "aodv-rqueue.h"
 #include "aodv-packet.h"
+#include "aodv-packet-view.h"
 #include "aodv-neighbor.h"
 #include "aodv-dpd.h"
+#include "aodv-bloom-dpd.h"
+#include "aodv-timer-service.h"
+#include "aodv-hello-template.h"
+#include "aodv-multipath.h"
+#include "aodv-attack-behavior.h"
+#include "aodv-route-policy.h"
 #include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/traced-callback.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv4-l3-protocol.h"
+#include <deque>
 #include <map>
+#include <set>
 
 namespace ns3 {
 namespace aodv {
@@ -174,6 +185,107 @@ public:
     return m_enableBroadcast;
   }
 
+  /**
+   * Get broadcast duplicate detection prefilter, e.g. to read its hit counters
+   * \returns the prefilter
+   */
+  const BloomDuplicatePacketDetection & GetDpdPrefilter () const
+  {
+    return m_dpdPrefilter;
+  }
+  /**
+   * Get routing table size, e.g. to watch it grow under a Sybil attack
+   * \returns the number of routing table entries, including expired ones not purged yet
+   */
+  uint32_t GetRoutingTableSize () const
+  {
+    return m_routingTable.GetSize ();
+  }
+  /**
+   * Get RREQ ID cache size, e.g. to watch it grow under a RREQ flood
+   * \returns the number of RREQs remembered as seen
+   */
+  uint32_t GetRreqIdCacheSize ()
+  {
+    return m_rreqIdCache.GetSize ();
+  }
+  /**
+   * Get request queue size
+   * \returns the number of packets waiting for a route
+   */
+  uint32_t GetQueueSize ()
+  {
+    return m_queue.GetSize ();
+  }
+  /**
+   * Set attack behavior, replacing the one made from the "AttackBehavior" attribute.
+   * It takes effect while the attack is active.
+   * \param attack the attack behavior, 0 for an honest node
+   */
+  void SetAttackBehavior (Ptr<AttackBehavior> attack);
+  /**
+   * Get attack behavior
+   * \returns the attack behavior, whether active or not
+   */
+  Ptr<AttackBehavior> GetAttackBehavior () const
+  {
+    return m_attackBehavior;
+  }
+  /**
+   * Switch the attack behavior on or off; an inactive attacker behaves as an honest node
+   * \param active true to switch the attack on
+   */
+  void SetAttackActive (bool active);
+  /**
+   * \returns true if the attack behavior is in effect
+   */
+  bool IsAttackActive () const
+  {
+    return m_attackActive;
+  }
+  /**
+   * Schedule an activation window of the attack
+   * \param start the simulation time the attack is switched on
+   * \param stop the simulation time the attack is switched off, 0 to keep it on
+   */
+  void ScheduleAttack (Time start, Time stop);
+  /**
+   * TracedCallback signature for attack state changes
+   * \param [in] active true if the attack was switched on, false if off
+   */
+  typedef void (* AttackStateTracedCallback)(bool active);
+  /**
+   * Set next hop policy applied to every data packet this node sends or forwards
+   * \param policy the policy
+   */
+  void SetRoutePolicy (RoutePolicy const & policy)
+  {
+    m_routePolicy = policy;
+  }
+  /**
+   * Get next hop policy, e.g. to change it during the simulation
+   * \returns the policy
+   */
+  RoutePolicy & GetRoutePolicy ()
+  {
+    return m_routePolicy;
+  }
+  /**
+   * Process a control packet that arrived over an out of band tunnel, see WormholeAttack.
+   * It is handled as if received on the first interface.
+   * \param packet the packet, starting with the type header
+   * \param sender the tunnel endpoint the packet came from
+   */
+  void RecvTunneled (Ptr<Packet> packet, Ipv4Address sender);
+  /**
+   * Send on a data packet that arrived over an out of band tunnel, see WormholeAttack.
+   * A packet addressed to this node is delivered locally; otherwise it is dropped if
+   * there is no valid route to its destination.
+   * \param p the packet without IP header
+   * \param header the IP header
+   */
+  void ForwardTunneled (Ptr<Packet> p, Ipv4Header const & header);
+
   void SetCalculationsStartCallback(Callback<void> callback);
   void SetCalculationsStopCallback(Callback<void> callback);
 
@@ -187,6 +299,20 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Install a valid route without route discovery, e.g. from a topology
+   * snapshot before the simulation starts. An existing route to dst is
+   * replaced, keeping its precursors.
+   *
+   * \param dst the destination IP address
+   * \param nextHop the next hop IP address, must be on the subnet of an AODV interface
+   * \param hops the hop count
+   * \param lifetime the route lifetime
+   * \param precursors the neighbors using this route
+   */
+  void SeedRoute (Ipv4Address dst, Ipv4Address nextHop, uint16_t hops, Time lifetime,
+                  std::vector<Ipv4Address> const & precursors = std::vector<Ipv4Address> ());
+
 protected:
   virtual void DoInitialize (void);
 private:
@@ -228,6 +354,19 @@ private:
   bool m_enableHello;                  ///< Indicates whether a hello messages enable
   bool m_enableBroadcast;              ///< Indicates whether a a broadcast data packets forwarding enable
   bool m_enableHelloFloodPrevention;
+  bool m_enableDpdPrefilter;           ///< Indicates whether broadcast duplicate detection uses the Bloom prefilter
+  uint32_t m_dpdPrefilterCapacity;     ///< Expected number of live duplicate detection records
+  double m_dpdPrefilterFpRate;         ///< Target false positive rate of the duplicate detection prefilter
+  Time m_rerrAggregationWindow;        ///< Time RERRs are held to merge unreachable destinations, 0 sends them at once
+  bool m_enableMultipath;              ///< Indicates whether alternate paths are kept for failover
+  uint32_t m_maxAlternatePaths;        ///< Maximum number of alternate paths per destination
+  bool m_enableLocalRepair;            ///< Indicates whether intermediate nodes repair broken routes locally
+  uint16_t m_maxRepairTtl;             ///< Maximum hop count to a destination for which local repair is tried
+  uint16_t m_localAddTtl;              ///< TTL added to the last known hop count of a route under local repair
+  ObjectFactory m_attackFactory;       ///< Makes the attack behavior of this node
+  bool m_isBlackHole;                  ///< Indicates whether the node is a black hole, overrides m_attackFactory
+  Time m_attackStart;                  ///< Time the attack behavior is switched on
+  Time m_attackStop;                   ///< Time the attack behavior is switched off, 0 keeps it on
   //\}
 
   /// IP protocol
@@ -236,6 +375,8 @@ private:
   std::map< Ptr<Socket>, Ipv4InterfaceAddress > m_socketAddresses;
   /// Raw subnet directed broadcast socket per each IP interface, map socket -> iface address (IP + mask)
   std::map< Ptr<Socket>, Ipv4InterfaceAddress > m_socketSubnetBroadcastAddresses;
+  /// HELLO template per each unicast socket, built on first HELLO
+  std::map< Ptr<Socket>, HelloTemplate > m_helloTemplates;
   /// Loopback device used to defer RREQ until packet will be fully formed
   Ptr<NetDevice> m_lo;
 
@@ -251,10 +392,32 @@ private:
   IdCache m_rreqIdCache;
   /// Handle duplicated broadcast/multicast packets
   DuplicatePacketDetection m_dpd;
+  /// Bloom prefiltered replacement of m_dpd, used when m_enableDpdPrefilter is set
+  BloomDuplicatePacketDetection m_dpdPrefilter;
   /// Handle neighbors
   Neighbors m_nb;
-  /// Number of RREQs used for RREQ rate control
-  uint16_t m_rreqCount;
+  /// Alternate paths, used when m_enableMultipath is set
+  AlternatePathTable m_alternatePaths;
+  /// Next hop overrides and blacklist
+  RoutePolicy m_routePolicy;
+  /// Honest behavior, in effect while the attack is inactive
+  Ptr<AttackBehavior> m_honest;
+  /// Configured attack behavior, m_honest for an honest node
+  Ptr<AttackBehavior> m_attackBehavior;
+  /// Behavior in effect: m_attackBehavior while the attack is active, m_honest otherwise
+  Ptr<AttackBehavior> m_attack;
+  /// Indicates whether m_attackBehavior is in effect
+  bool m_attackActive;
+  /// Fired when the attack is switched on (true) or off (false)
+  TracedCallback<bool> m_attackStateChangedTrace;
+  /// RREQ tokens available, refilled at RreqRateLimit per second up to RreqRateLimit
+  double m_rreqTokens;
+  /// Time m_rreqTokens was last refilled
+  Time m_rreqTokensUpdate;
+  /// Destinations waiting for a RREQ token, in arrival order
+  std::deque<Ipv4Address> m_pendingRreqs;
+  /// Destinations in m_pendingRreqs
+  std::set<Ipv4Address> m_pendingRreqSet;
   /// Number of RERRs used for RERR rate control
   uint16_t m_rerrCount;
 
@@ -325,10 +488,10 @@ protected:
   /**
  * Process hello message
  *
- * \param rrepHeader RREP message header
+ * \param hello view of the RREP message
  * \param receiverIfaceAddr receiver interface IP address
  */
-  void ProcessHello (RrepHeader const & rrepHeader, Ipv4Address receiverIfaceAddr);
+  void ProcessHello (AodvPacketView const & hello, Ipv4Address receiverIfaceAddr);
 
 private:
   /**
@@ -344,13 +507,15 @@ private:
   //\{
   /// Receive and process control packet
   void RecvAodv (Ptr<Socket> socket);
-  /// Receive RREQ
-  void RecvRequest (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src);
-  /// Receive RREP
-  void RecvReply (Ptr<Packet> p, Ipv4Address my,Ipv4Address src);
+  /// Process control packet from neighbor sender received on interface with address receiver
+  void RecvAodvPacket (Ptr<Packet> packet, Ipv4Address sender, Ipv4Address receiver);
+  /// Receive RREQ, p still carries the type header, view is a view of p
+  void RecvRequest (Ptr<Packet> p, AodvPacketView const & view, Ipv4Address receiver, Ipv4Address src);
+  /// Receive RREP, p still carries the type header, view is a view of p
+  void RecvReply (Ptr<Packet> p, AodvPacketView const & view, Ipv4Address my,Ipv4Address src);
   /// Receive RREP_ACK
   void RecvReplyAck (Ipv4Address neighbor);
-  /// Receive RERR from node with address src
+  /// Receive RERR from node with address src, p still carries the type header
   void RecvError (Ptr<Packet> p, Ipv4Address src);
   //\}
 
@@ -360,8 +525,10 @@ private:
   void SendPacketFromQueue (Ipv4Address dst, Ptr<Ipv4Route> route);
   /// Send hello
   void SendHello ();
-  /// Send RREQ
+  /// Send RREQ if a RREQ token is available, queue the destination otherwise
   void SendRequest (Ipv4Address dst);
+  /// Send RREQ regardless of the rate limit
+  void DoSendRequest (Ipv4Address dst);
   /// Send RREP
   void SendReply (RreqHeader const & rreqHeader, RoutingTableEntry const & toOrigin);
   /** Send RREP by intermediate node
@@ -393,20 +560,32 @@ private:
    */
   void SendTo (Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination);
 
+  /// Timers of this node, multiplexed on a single simulator event
+  TimerService m_timers;
   /// Hello timer
-  Timer m_htimer;
+  TimerService::Handle m_htimer;
   /// Schedule next send of hello message
   void HelloTimerExpire ();
-  /// RREQ rate limit timer
-  Timer m_rreqRateLimitTimer;
-  /// Reset RREQ count and schedule RREQ rate limit timer with delay 1 sec.
-  void RreqRateLimitTimerExpire ();
+  /// Flooded RREQ timer of the attack behavior
+  TimerService::Handle m_rreqFloodTimer;
+  /// (Re)start flooding RREQs if the attack behavior floods them
+  void ScheduleRreqFlood ();
+  /// Send flooded RREQ
+  void RreqFloodTimerExpire ();
+  /// Timer releasing queued RREQs when the next token accrues
+  TimerService::Handle m_rreqReleaseTimer;
+  /// Add tokens accrued since the last refill
+  void RefillRreqTokens ();
+  /// Schedule m_rreqReleaseTimer for the next token if RREQs are queued
+  void ScheduleRreqRelease ();
+  /// Send queued RREQs while tokens are available
+  void ReleaseRreqs ();
   /// RERR rate limit timer
-  Timer m_rerrRateLimitTimer;
+  TimerService::Handle m_rerrRateLimitTimer;
   /// Reset RERR count and schedule RERR rate limit timer with delay 1 sec.
   void RerrRateLimitTimerExpire ();
-  /// Map IP address + RREQ timer.
-  std::map<Ipv4Address, Timer> m_addressReqTimer;
+  /// RREQ retry timers keyed by destination
+  RreqRetryTable m_addressReqTimer;
   /**
    * Handle route discovery process
    * \param dst the destination IP address
@@ -420,6 +599,77 @@ private:
    */
   void AckTimerExpire (Ipv4Address neighbor, Time blacklistTimeout);
 
+  ///\name RERR aggregation
+  //\{
+  /// Timer of the aggregated RERR flush
+  TimerService::Handle m_rerrFlushTimer;
+  /// Unreachable destinations waiting for the flush
+  std::map<Ipv4Address, uint32_t> m_rerrUnreachable;
+  /// Neighbors to send the aggregated RERR to
+  std::set<Ipv4Address> m_rerrPrecursors;
+  /// Indicates whether the aggregated RERR is broadcast on all interfaces
+  bool m_rerrBroadcast;
+  /**
+   * Add unreachable destinations to the aggregated RERR and start the aggregation window
+   * \param unreachable the unreachable destinations with their sequence numbers
+   * \param precursors the neighbors to notify
+   * \param broadcast true to broadcast the RERR on all interfaces
+   */
+  void QueueRerr (std::map<Ipv4Address, uint32_t> const & unreachable, std::vector<Ipv4Address> const & precursors, bool broadcast);
+  /// Send the aggregated RERR
+  void FlushRerr ();
+  /**
+   * Send one aggregated RERR message
+   * \param rerrHeader the RERR header
+   * \param precursors the neighbors to notify
+   * \param broadcast true to broadcast the RERR on all interfaces
+   */
+  void SendAggregatedRerr (RerrHeader const & rerrHeader, std::vector<Ipv4Address> const & precursors, bool broadcast);
+  //\}
+
+  ///\name Multipath
+  //\{
+  /**
+   * Keep path as an alternate one unless it goes through the next hop of the active route
+   * \param dst the destination
+   * \param path the path
+   */
+  void AddAlternatePath (Ipv4Address dst, AlternatePath const & path);
+  /**
+   * Install the shortest alternate path to destination in the routing table
+   * \param dst the destination
+   * \param excluded next hop known to be unusable for the destination
+   * \returns true if a path was installed
+   */
+  bool FailOver (Ipv4Address dst, Ipv4Address excluded);
+  //\}
+
+  ///\name Local repair
+  //\{
+  /// State of a route under local repair
+  struct LocalRepair
+  {
+    /// TTL of the repair RREQ
+    uint16_t m_ttl;
+    /// Precursors of the route, notified if the repair fails
+    std::vector<Ipv4Address> m_precursors;
+  };
+  /// Destinations under local repair
+  std::map<Ipv4Address, LocalRepair> m_localRepair;
+  /**
+   * Start local repair of the route to destination after its next hop broke
+   * \param dst the destination
+   * \returns true if the repair started, false if the route is not eligible
+   */
+  bool StartLocalRepair (Ipv4Address dst);
+  /**
+   * End local repair of the route to destination
+   * \param dst the destination
+   * \param repaired true if a new route was found
+   */
+  void FinishLocalRepair (Ipv4Address dst, bool repaired);
+  //\}
+
   /// Provides uniform random variables.
   Ptr<UniformRandomVariable> m_uniformRandomVariable;
   /// Keep track of the last bcast time
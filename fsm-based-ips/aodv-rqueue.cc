@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Based on
+ *      NS-2 AODV model developed by the CMU/MONARCH group and optimized and
+ *      tuned by Samir Das and Mahesh Marina, University of Cincinnati;
+ *
+ *      AODV-UU implementation by Erik Nordström of Uppsala University
+ *      http://core.it.uu.se/core/index.php/AODV-UU
+ *
+ * Authors: Elena Buchatskaia <borovkovaes@iitp.ru>
+ *          Pavel Boyko <boyko@iitp.ru>
+ */
+#include "aodv-rqueue.h"
+#include "ns3/socket.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvRequestQueue");
+
+namespace aodv {
+uint32_t
+RequestQueue::GetSize ()
+{
+  Purge ();
+  return m_queue.size ();
+}
+
+bool
+RequestQueue::Enqueue (QueueEntry & entry)
+{
+  Purge ();
+  Ipv4Address dst = entry.GetIpv4Header ().GetDestination ();
+  std::unordered_map<Ipv4Address, Bucket, Ipv4AddressHash>::const_iterator b = m_buckets.find (dst);
+  if (b != m_buckets.end ())
+    {
+      for (Bucket::const_iterator i = b->second.begin (); i != b->second.end (); ++i)
+        {
+          if ((*i)->GetPacket ()->GetUid () == entry.GetPacket ()->GetUid ())
+            {
+              return false;
+            }
+        }
+    }
+  entry.SetExpireTime (m_queueTimeout);
+  while (!m_queue.empty () && m_queue.size () >= m_maxLen)
+    {
+      Drop (m_queue.front (), "Drop the most aged packet"); // Drop the most aged packet
+      EraseFront (m_queue.begin ());
+    }
+  m_buckets[dst].push_back (m_queue.insert (m_queue.end (), entry));
+  return true;
+}
+
+void
+RequestQueue::EraseFront (EntryList::iterator i)
+{
+  std::unordered_map<Ipv4Address, Bucket, Ipv4AddressHash>::iterator b =
+    m_buckets.find (i->GetIpv4Header ().GetDestination ());
+  NS_ASSERT (b != m_buckets.end () && b->second.front () == i);
+  b->second.pop_front ();
+  if (b->second.empty ())
+    {
+      m_buckets.erase (b);
+    }
+  m_queue.erase (i);
+}
+
+void
+RequestQueue::DropPacketWithDst (Ipv4Address dst)
+{
+  NS_LOG_FUNCTION (this << dst);
+  Purge ();
+  std::unordered_map<Ipv4Address, Bucket, Ipv4AddressHash>::iterator b = m_buckets.find (dst);
+  if (b == m_buckets.end ())
+    {
+      return;
+    }
+  for (Bucket::const_iterator i = b->second.begin (); i != b->second.end (); ++i)
+    {
+      Drop (**i, "DropPacketWithDst ");
+      m_queue.erase (*i);
+    }
+  m_buckets.erase (b);
+}
+
+bool
+RequestQueue::Dequeue (Ipv4Address dst, QueueEntry & entry)
+{
+  Purge ();
+  std::unordered_map<Ipv4Address, Bucket, Ipv4AddressHash>::iterator b = m_buckets.find (dst);
+  if (b == m_buckets.end ())
+    {
+      return false;
+    }
+  entry = *b->second.front ();
+  EraseFront (b->second.front ());
+  return true;
+}
+
+bool
+RequestQueue::Find (Ipv4Address dst)
+{
+  return m_buckets.find (dst) != m_buckets.end ();
+}
+
+void
+RequestQueue::Purge ()
+{
+  while (!m_queue.empty () && m_queue.front ().GetExpireTime () < Seconds (0))
+    {
+      Drop (m_queue.front (), "Drop outdated packet ");
+      EraseFront (m_queue.begin ());
+    }
+}
+
+void
+RequestQueue::Drop (QueueEntry en, std::string reason)
+{
+  NS_LOG_LOGIC (reason << en.GetPacket ()->GetUid () << " " << en.GetIpv4Header ().GetDestination ());
+  en.GetErrorCallback () (en.GetPacket (), en.GetIpv4Header (),
+                          Socket::ERROR_NOROUTETOHOST);
+  return;
+}
+
+}  // namespace aodv
+}  // namespace ns3
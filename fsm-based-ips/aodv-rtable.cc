@@ -0,0 +1,542 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Based on
+ *      NS-2 AODV model developed by the CMU/MONARCH group and optimized and
+ *      tuned by Samir Das and Mahesh Marina, University of Cincinnati;
+ *
+ *      AODV-UU implementation by Erik Nordström of Uppsala University
+ *      http://core.it.uu.se/core/index.php/AODV-UU
+ *
+ * Authors: Elena Buchatskaia <borovkovaes@iitp.ru>
+ *          Pavel Boyko <boyko@iitp.ru>
+ */
+
+#include "aodv-rtable.h"
+#include <algorithm>
+#include <iomanip>
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvRoutingTable");
+
+namespace aodv {
+
+/*
+ The precursor set
+ */
+
+bool
+PrecursorSet::Insert (Ipv4Address id)
+{
+  if (!m_spill.empty ())
+    {
+      return m_spill.insert (id).second;
+    }
+  if (Contains (id))
+    {
+      return false;
+    }
+  if (m_count < INLINE_SIZE)
+    {
+      m_inline[m_count++] = id;
+      return true;
+    }
+  m_spill.insert (m_inline, m_inline + m_count);
+  m_spill.insert (id);
+  m_count = 0;
+  return true;
+}
+
+bool
+PrecursorSet::Contains (Ipv4Address id) const
+{
+  if (!m_spill.empty ())
+    {
+      return m_spill.find (id) != m_spill.end ();
+    }
+  return std::find (m_inline, m_inline + m_count, id) != m_inline + m_count;
+}
+
+bool
+PrecursorSet::Erase (Ipv4Address id)
+{
+  if (!m_spill.empty ())
+    {
+      if (m_spill.erase (id) == 0)
+        {
+          return false;
+        }
+      if (m_spill.size () <= INLINE_SIZE)
+        {
+          // Move back in place, so copies of the entry are cheap again
+          std::copy (m_spill.begin (), m_spill.end (), m_inline);
+          m_count = m_spill.size ();
+          std::unordered_set<Ipv4Address, Ipv4AddressHash> ().swap (m_spill);
+        }
+      return true;
+    }
+  Ipv4Address * end = m_inline + m_count;
+  Ipv4Address * i = std::find (m_inline, end, id);
+  if (i == end)
+    {
+      return false;
+    }
+  *i = *(end - 1);
+  --m_count;
+  return true;
+}
+
+void
+PrecursorSet::Clear ()
+{
+  m_count = 0;
+  std::unordered_set<Ipv4Address, Ipv4AddressHash> ().swap (m_spill);
+}
+
+void
+PrecursorSet::AppendTo (std::vector<Ipv4Address> & prec) const
+{
+  // Precursors of the set are distinct, so only the addresses already in prec are checked
+  std::vector<Ipv4Address>::size_type known = prec.size ();
+  if (!m_spill.empty ())
+    {
+      for (std::unordered_set<Ipv4Address, Ipv4AddressHash>::const_iterator i = m_spill.begin ();
+           i != m_spill.end (); ++i)
+        {
+          if (std::find (prec.begin (), prec.begin () + known, *i) == prec.begin () + known)
+            {
+              prec.push_back (*i);
+            }
+        }
+      return;
+    }
+  for (uint32_t i = 0; i < m_count; ++i)
+    {
+      if (std::find (prec.begin (), prec.begin () + known, m_inline[i]) == prec.begin () + known)
+        {
+          prec.push_back (m_inline[i]);
+        }
+    }
+}
+
+/*
+ The Routing Table
+ */
+
+RoutingTableEntry::RoutingTableEntry (Ptr<NetDevice> dev, Ipv4Address dst, bool vSeqNo, uint32_t seqNo,
+                                      Ipv4InterfaceAddress iface, uint16_t hops, Ipv4Address nextHop, Time lifetime)
+  : m_ackTimer (Timer::CANCEL_ON_DESTROY),
+    m_validSeqNo (vSeqNo),
+    m_seqNo (seqNo),
+    m_hops (hops),
+    m_lifeTime (lifetime + Simulator::Now ()),
+    m_iface (iface),
+    m_flag (VALID),
+    m_reqCount (0),
+    m_blackListState (false),
+    m_blackListTimeout (Simulator::Now ())
+{
+  m_ipv4Route = Create<Ipv4Route> ();
+  m_ipv4Route->SetDestination (dst);
+  m_ipv4Route->SetGateway (nextHop);
+  m_ipv4Route->SetSource (m_iface.GetLocal ());
+  m_ipv4Route->SetOutputDevice (dev);
+}
+
+RoutingTableEntry::~RoutingTableEntry ()
+{
+}
+
+bool
+RoutingTableEntry::InsertPrecursor (Ipv4Address id)
+{
+  NS_LOG_FUNCTION (this << id);
+  return m_precursors.Insert (id);
+}
+
+bool
+RoutingTableEntry::LookupPrecursor (Ipv4Address id)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (m_precursors.Contains (id))
+    {
+      NS_LOG_LOGIC ("Precursor " << id << " found");
+      return true;
+    }
+  NS_LOG_LOGIC ("Precursor " << id << " not found");
+  return false;
+}
+
+bool
+RoutingTableEntry::DeletePrecursor (Ipv4Address id)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (!m_precursors.Erase (id))
+    {
+      NS_LOG_LOGIC ("Precursor " << id << " not found");
+      return false;
+    }
+  NS_LOG_LOGIC ("Precursor " << id << " found");
+  return true;
+}
+
+void
+RoutingTableEntry::DeleteAllPrecursors ()
+{
+  NS_LOG_FUNCTION (this);
+  m_precursors.Clear ();
+}
+
+bool
+RoutingTableEntry::IsPrecursorListEmpty () const
+{
+  return m_precursors.IsEmpty ();
+}
+
+void
+RoutingTableEntry::GetPrecursors (std::vector<Ipv4Address> & prec) const
+{
+  NS_LOG_FUNCTION (this);
+  m_precursors.AppendTo (prec);
+}
+
+void
+RoutingTableEntry::Invalidate (Time badLinkLifetime)
+{
+  NS_LOG_FUNCTION (this << badLinkLifetime.GetSeconds ());
+  if (m_flag == INVALID)
+    {
+      return;
+    }
+  m_flag = INVALID;
+  m_reqCount = 0;
+  m_lifeTime = badLinkLifetime + Simulator::Now ();
+}
+
+void
+RoutingTableEntry::Print (Ptr<OutputStreamWrapper> stream) const
+{
+  std::ostream* os = stream->GetStream ();
+  *os << m_ipv4Route->GetDestination () << "\t" << m_ipv4Route->GetGateway ()
+      << "\t" << m_iface.GetLocal () << "\t";
+  switch (m_flag)
+    {
+    case VALID:
+      {
+        *os << "UP";
+        break;
+      }
+    case INVALID:
+      {
+        *os << "DOWN";
+        break;
+      }
+    case IN_SEARCH:
+      {
+        *os << "IN_SEARCH";
+        break;
+      }
+    }
+  *os << "\t";
+  *os << std::setiosflags (std::ios::fixed) <<
+  std::setiosflags (std::ios::left) << std::setprecision (2) <<
+  std::setw (14) << (m_lifeTime - Simulator::Now ()).GetSeconds ();
+  *os << "\t" << m_hops << "\n";
+}
+
+/*
+ The Routing Table
+ */
+
+RoutingTable::RoutingTable (Time t)
+  : m_badLinkLifetime (t)
+{
+}
+
+bool
+RoutingTable::LookupRoute (Ipv4Address id, RoutingTableEntry & rt)
+{
+  NS_LOG_FUNCTION (this << id);
+  Purge ();
+  if (m_ipv4AddressEntry.empty ())
+    {
+      NS_LOG_LOGIC ("Route to " << id << " not found; m_ipv4AddressEntry is empty");
+      return false;
+    }
+  std::map<Ipv4Address, RoutingTableEntry>::const_iterator i =
+    m_ipv4AddressEntry.find (id);
+  if (i == m_ipv4AddressEntry.end ())
+    {
+      NS_LOG_LOGIC ("Route to " << id << " not found");
+      return false;
+    }
+  rt = i->second;
+  NS_LOG_LOGIC ("Route to " << id << " found");
+  return true;
+}
+
+bool
+RoutingTable::LookupValidRoute (Ipv4Address id, RoutingTableEntry & rt)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (!LookupRoute (id, rt))
+    {
+      NS_LOG_LOGIC ("Route to " << id << " not found");
+      return false;
+    }
+  NS_LOG_LOGIC ("Route to " << id << " flag is " << ((rt.GetFlag () == VALID) ? "valid" : "not valid"));
+  return (rt.GetFlag () == VALID);
+}
+
+bool
+RoutingTable::DeleteRoute (Ipv4Address dst)
+{
+  NS_LOG_FUNCTION (this << dst);
+  Purge ();
+  if (m_ipv4AddressEntry.erase (dst) != 0)
+    {
+      NS_LOG_LOGIC ("Route deletion to " << dst << " successful");
+      return true;
+    }
+  NS_LOG_LOGIC ("Route deletion to " << dst << " not successful");
+  return false;
+}
+
+bool
+RoutingTable::AddRoute (RoutingTableEntry & rt)
+{
+  NS_LOG_FUNCTION (this);
+  Purge ();
+  if (rt.GetFlag () != IN_SEARCH)
+    {
+      rt.SetRreqCnt (0);
+    }
+  std::pair<std::map<Ipv4Address, RoutingTableEntry>::iterator, bool> result =
+    m_ipv4AddressEntry.insert (std::make_pair (rt.GetDestination (), rt));
+  return result.second;
+}
+
+bool
+RoutingTable::Update (RoutingTableEntry & rt)
+{
+  NS_LOG_FUNCTION (this);
+  std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+    m_ipv4AddressEntry.find (rt.GetDestination ());
+  if (i == m_ipv4AddressEntry.end ())
+    {
+      NS_LOG_LOGIC ("Route update to " << rt.GetDestination () << " fails; not found");
+      return false;
+    }
+  i->second = rt;
+  if (i->second.GetFlag () != IN_SEARCH)
+    {
+      NS_LOG_LOGIC ("Route update to " << rt.GetDestination () << " set RreqCnt to 0");
+      i->second.SetRreqCnt (0);
+    }
+  return true;
+}
+
+bool
+RoutingTable::SetEntryState (Ipv4Address id, RouteFlags state)
+{
+  NS_LOG_FUNCTION (this);
+  std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+    m_ipv4AddressEntry.find (id);
+  if (i == m_ipv4AddressEntry.end ())
+    {
+      NS_LOG_LOGIC ("Route set entry state to " << id << " fails; not found");
+      return false;
+    }
+  i->second.SetFlag (state);
+  i->second.SetRreqCnt (0);
+  NS_LOG_LOGIC ("Route set entry state to " << id << ": new state is " << state);
+  return true;
+}
+
+void
+RoutingTable::GetListOfDestinationWithNextHop (Ipv4Address nextHop, std::map<Ipv4Address, uint32_t> & unreachable )
+{
+  NS_LOG_FUNCTION (this);
+  Purge ();
+  unreachable.clear ();
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator i =
+         m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); ++i)
+    {
+      if (i->second.GetNextHop () == nextHop)
+        {
+          NS_LOG_LOGIC ("Unreachable insert " << i->first << " " << i->second.GetSeqNo ());
+          unreachable.insert (std::make_pair (i->first, i->second.GetSeqNo ()));
+        }
+    }
+}
+
+void
+RoutingTable::InvalidateRoutesWithDst (const std::map<Ipv4Address, uint32_t> & unreachable)
+{
+  NS_LOG_FUNCTION (this);
+  Purge ();
+  for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+         m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); ++i)
+    {
+      for (std::map<Ipv4Address, uint32_t>::const_iterator j =
+             unreachable.begin (); j != unreachable.end (); ++j)
+        {
+          if ((i->first == j->first) && (i->second.GetFlag () == VALID))
+            {
+              NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
+              i->second.Invalidate (m_badLinkLifetime);
+            }
+        }
+    }
+}
+
+void
+RoutingTable::DeleteAllRoutesFromInterface (Ipv4InterfaceAddress iface)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ipv4AddressEntry.empty ())
+    {
+      return;
+    }
+  for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+         m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); )
+    {
+      if (i->second.GetInterface () == iface)
+        {
+          std::map<Ipv4Address, RoutingTableEntry>::iterator tmp = i;
+          ++i;
+          m_ipv4AddressEntry.erase (tmp);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+void
+RoutingTable::Purge ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ipv4AddressEntry.empty ())
+    {
+      return;
+    }
+  for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+         m_ipv4AddressEntry.begin (); i != m_ipv4AddressEntry.end (); )
+    {
+      if (i->second.GetLifeTime () < Seconds (0))
+        {
+          if (i->second.GetFlag () == INVALID)
+            {
+              std::map<Ipv4Address, RoutingTableEntry>::iterator tmp = i;
+              ++i;
+              m_ipv4AddressEntry.erase (tmp);
+            }
+          else if (i->second.GetFlag () == VALID)
+            {
+              NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
+              i->second.Invalidate (m_badLinkLifetime);
+              ++i;
+            }
+          else
+            {
+              ++i;
+            }
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+void
+RoutingTable::Purge (std::map<Ipv4Address, RoutingTableEntry> &table) const
+{
+  NS_LOG_FUNCTION (this);
+  if (table.empty ())
+    {
+      return;
+    }
+  for (std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+         table.begin (); i != table.end (); )
+    {
+      if (i->second.GetLifeTime () < Seconds (0))
+        {
+          if (i->second.GetFlag () == INVALID)
+            {
+              std::map<Ipv4Address, RoutingTableEntry>::iterator tmp = i;
+              ++i;
+              table.erase (tmp);
+            }
+          else if (i->second.GetFlag () == VALID)
+            {
+              NS_LOG_LOGIC ("Invalidate route with destination address " << i->first);
+              i->second.Invalidate (m_badLinkLifetime);
+              ++i;
+            }
+          else
+            {
+              ++i;
+            }
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
+bool
+RoutingTable::MarkLinkAsUnidirectional (Ipv4Address neighbor, Time blacklistTimeout)
+{
+  NS_LOG_FUNCTION (this << neighbor << blacklistTimeout.GetSeconds ());
+  std::map<Ipv4Address, RoutingTableEntry>::iterator i =
+    m_ipv4AddressEntry.find (neighbor);
+  if (i == m_ipv4AddressEntry.end ())
+    {
+      NS_LOG_LOGIC ("Mark link unidirectional to  " << neighbor << " fails; not found");
+      return false;
+    }
+  i->second.SetUnidirectional (true);
+  i->second.SetBalcklistTimeout (blacklistTimeout);
+  i->second.SetRreqCnt (0);
+  NS_LOG_LOGIC ("Set link to " << neighbor << " to unidirectional");
+  return true;
+}
+
+void
+RoutingTable::Print (Ptr<OutputStreamWrapper> stream) const
+{
+  std::map<Ipv4Address, RoutingTableEntry> table = m_ipv4AddressEntry;
+  Purge (table);
+  *stream->GetStream () << "\nAODV Routing table\n"
+                        << "Destination\tGateway\t\tInterface\tFlag\tExpire\t\tHops\n";
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator i =
+         table.begin (); i != table.end (); ++i)
+    {
+      i->second.Print (stream);
+    }
+  *stream->GetStream () << "\n";
+}
+
+}
+}
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "aodv-timer-service.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AodvTimerService");
+
+namespace aodv {
+
+/// Free list terminator
+static const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max ();
+
+TimerService::TimerService ()
+  : m_freeSlot (NO_SLOT),
+    m_order (0),
+    m_pending (0),
+    m_expiring (false)
+{
+}
+
+TimerService::~TimerService ()
+{
+  Simulator::Cancel (m_event);
+}
+
+TimerService::Handle
+TimerService::Schedule (Time delay, Function fn)
+{
+  NS_ASSERT (delay.IsPositive ());
+  NS_ASSERT (fn);
+  uint32_t index = m_freeSlot;
+  if (index == NO_SLOT)
+    {
+      index = m_slots.size ();
+      Slot slot;
+      slot.m_generation = 1;
+      slot.m_nextFree = NO_SLOT;
+      m_slots.push_back (slot);
+    }
+  else
+    {
+      m_freeSlot = m_slots[index].m_nextFree;
+    }
+  Slot & slot = m_slots[index];
+  slot.m_function = fn;
+  slot.m_deadline = Simulator::Now () + delay;
+  ++m_pending;
+
+  Deadline d;
+  d.m_deadline = slot.m_deadline;
+  d.m_order = m_order++;
+  d.m_slot = index;
+  d.m_generation = slot.m_generation;
+  m_deadlines.push (d);
+  Arm ();
+  return (static_cast<Handle> (slot.m_generation) << 32) | index;
+}
+
+const TimerService::Slot *
+TimerService::Find (Handle h) const
+{
+  uint32_t index = static_cast<uint32_t> (h);
+  if (index >= m_slots.size () || m_slots[index].m_generation != static_cast<uint32_t> (h >> 32)
+      || !m_slots[index].m_function)
+    {
+      return 0;
+    }
+  return &m_slots[index];
+}
+
+bool
+TimerService::Cancel (Handle h)
+{
+  if (Find (h) == 0)
+    {
+      return false;
+    }
+  Release (static_cast<uint32_t> (h));
+  return true;
+}
+
+bool
+TimerService::IsRunning (Handle h) const
+{
+  return Find (h) != 0;
+}
+
+Time
+TimerService::GetDelayLeft (Handle h) const
+{
+  const Slot * slot = Find (h);
+  if (slot == 0)
+    {
+      return Seconds (0);
+    }
+  return slot->m_deadline - Simulator::Now ();
+}
+
+void
+TimerService::Release (uint32_t index)
+{
+  Slot & slot = m_slots[index];
+  slot.m_function = Function ();
+  // Generation 0 is skipped to keep handle 0 invalid
+  if (++slot.m_generation == 0)
+    {
+      slot.m_generation = 1;
+    }
+  slot.m_nextFree = m_freeSlot;
+  m_freeSlot = index;
+  --m_pending;
+}
+
+void
+TimerService::CancelAll ()
+{
+  for (uint32_t i = 0; i < m_slots.size (); ++i)
+    {
+      if (m_slots[i].m_function)
+        {
+          Release (i);
+        }
+    }
+  m_deadlines = std::priority_queue<Deadline, std::vector<Deadline>, Later> ();
+  Simulator::Cancel (m_event);
+}
+
+void
+TimerService::Arm ()
+{
+  if (m_expiring)
+    {
+      return;
+    }
+  while (!m_deadlines.empty () && !IsLive (m_deadlines.top ()))
+    {
+      m_deadlines.pop ();
+    }
+  if (m_deadlines.empty ())
+    {
+      return;
+    }
+  Time deadline = m_deadlines.top ().m_deadline;
+  if (m_event.IsRunning () && m_eventTime <= deadline)
+    {
+      return;
+    }
+  Simulator::Cancel (m_event);
+  m_eventTime = deadline;
+  m_event = Simulator::Schedule (deadline - Simulator::Now (), &TimerService::Expire, this);
+}
+
+void
+TimerService::Expire ()
+{
+  NS_LOG_FUNCTION (this);
+  m_event = EventId ();
+  m_expiring = true;
+  // Timers scheduled by a running function with zero delay are due too and run in this loop
+  while (!m_deadlines.empty () && m_deadlines.top ().m_deadline <= Simulator::Now ())
+    {
+      Deadline d = m_deadlines.top ();
+      m_deadlines.pop ();
+      if (!IsLive (d))
+        {
+          continue;
+        }
+      // The function may schedule new timers and grow the pool, so take it out of the slot first
+      Function fn;
+      fn.swap (m_slots[d.m_slot].m_function);
+      Release (d.m_slot);
+      fn ();
+    }
+  m_expiring = false;
+  Arm ();
+}
+
+void
+RreqRetryTable::Schedule (Ipv4Address dst, Time delay, TimerService::Function fn)
+{
+  TimerService::Handle & h = m_retries[dst];
+  m_timers.Cancel (h);
+  h = m_timers.Schedule (delay, fn);
+}
+
+void
+RreqRetryTable::Cancel (Ipv4Address dst)
+{
+  std::unordered_map<Ipv4Address, TimerService::Handle, Ipv4AddressHash>::iterator i = m_retries.find (dst);
+  if (i != m_retries.end ())
+    {
+      m_timers.Cancel (i->second);
+      m_retries.erase (i);
+    }
+}
+
+bool
+RreqRetryTable::IsRunning (Ipv4Address dst) const
+{
+  std::unordered_map<Ipv4Address, TimerService::Handle, Ipv4AddressHash>::const_iterator i = m_retries.find (dst);
+  return i != m_retries.end () && m_timers.IsRunning (i->second);
+}
+
+}  // namespace aodv
+}  // namespace ns3
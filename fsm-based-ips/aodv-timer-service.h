@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AODV_TIMER_SERVICE_H
+#define AODV_TIMER_SERVICE_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace aodv {
+/**
+ * \ingroup aodv
+ *
+ * \brief Per node timer multiplexer.
+ *
+ * Keeps all timers of one routing protocol instance in its own deadline
+ * ordered queue and holds at most one event in the global simulator
+ * queue, for the earliest deadline. Timers sharing a deadline run in
+ * scheduling order from a single simulator event.
+ *
+ * Timers live in a pool of reusable slots. A handle is the slot index
+ * tagged with the slot generation, which is bumped every time the slot is
+ * released, so a stale handle never refers to a newer timer. Cancel is
+ * O(1): it releases the slot and leaves the deadline record in the queue
+ * to be skipped when it comes up. The simulator event is not touched on
+ * cancel either: if the cancelled timer was the earliest one, the event
+ * fires with nothing due and is re-armed for the next deadline.
+ */
+class TimerService
+{
+public:
+  /// Timer handle, 0 is never a valid handle
+  typedef uint64_t Handle;
+  /// Timer function
+  typedef std::function<void ()> Function;
+
+  /// Constructor
+  TimerService ();
+  /// Destructor, cancels pending simulator event
+  ~TimerService ();
+  /**
+   * Schedule function to run after delay
+   * \param delay the delay
+   * \param fn the function
+   * \returns the handle of the new timer
+   */
+  Handle Schedule (Time delay, Function fn);
+  /**
+   * Cancel timer. Cancelling an expired or already cancelled timer is a no-op.
+   * \param h the timer handle
+   * \returns true if the timer was pending
+   */
+  bool Cancel (Handle h);
+  /**
+   * \param h the timer handle
+   * \returns true if the timer is pending
+   */
+  bool IsRunning (Handle h) const;
+  /**
+   * \param h the timer handle
+   * \returns time left until the timer expires, 0 if it is not pending
+   */
+  Time GetDelayLeft (Handle h) const;
+  /// Cancel all timers
+  void CancelAll ();
+  /**
+   * \returns the number of pending timers
+   */
+  uint32_t GetSize () const
+  {
+    return m_pending;
+  }
+
+private:
+  /// Timer slot
+  struct Slot
+  {
+    /// Timer function, empty while the slot is free
+    Function m_function;
+    /// Expiration time
+    Time m_deadline;
+    /// Generation, bumped on release
+    uint32_t m_generation;
+    /// Next free slot, valid while the slot is free
+    uint32_t m_nextFree;
+  };
+  /// Deadline record
+  struct Deadline
+  {
+    /// Expiration time
+    Time m_deadline;
+    /// Scheduling order, breaks deadline ties
+    uint64_t m_order;
+    /// Timer slot
+    uint32_t m_slot;
+    /// Slot generation the record was made for
+    uint32_t m_generation;
+  };
+  /// Orders deadline records earliest first in std::priority_queue
+  struct Later
+  {
+    /**
+     * \param a deadline record
+     * \param b deadline record
+     * \returns true if a expires after b
+     */
+    bool operator() (const Deadline & a, const Deadline & b) const
+    {
+      if (a.m_deadline != b.m_deadline)
+        {
+          return b.m_deadline < a.m_deadline;
+        }
+      return a.m_order > b.m_order;
+    }
+  };
+
+  /**
+   * \param h the timer handle
+   * \returns the slot of pending timer h or 0 if the timer is not pending
+   */
+  const Slot * Find (Handle h) const;
+  /**
+   * \param d deadline record
+   * \returns true if the timer the record was made for is still pending
+   */
+  bool IsLive (const Deadline & d) const
+  {
+    return m_slots[d.m_slot].m_generation == d.m_generation;
+  }
+  /**
+   * Return slot to the free list
+   * \param index slot index
+   */
+  void Release (uint32_t index);
+  /// Run all due timers and re-arm the simulator event
+  void Expire ();
+  /// Make sure the simulator event fires no later than the earliest deadline
+  void Arm ();
+
+  /// Timer slots
+  std::vector<Slot> m_slots;
+  /// First free slot
+  uint32_t m_freeSlot;
+  /// Deadline records, including the ones of cancelled timers
+  std::priority_queue<Deadline, std::vector<Deadline>, Later> m_deadlines;
+  /// Scheduling order counter
+  uint64_t m_order;
+  /// Number of pending timers
+  uint32_t m_pending;
+  /// The simulator event
+  EventId m_event;
+  /// Time the simulator event fires at
+  Time m_eventTime;
+  /// True while due timers are being run
+  bool m_expiring;
+};
+
+/**
+ * \ingroup aodv
+ *
+ * \brief Route request retry timers keyed by destination.
+ *
+ * At most one retry timer per destination; scheduling a retry replaces
+ * the pending one.
+ */
+class RreqRetryTable
+{
+public:
+  /**
+   * Constructor
+   * \param timers the timer service to schedule retries with
+   */
+  RreqRetryTable (TimerService & timers)
+    : m_timers (timers)
+  {
+  }
+  /**
+   * Schedule retry for destination, cancelling the pending one
+   * \param dst the destination IP address
+   * \param delay the delay
+   * \param fn the function to run
+   */
+  void Schedule (Ipv4Address dst, Time delay, TimerService::Function fn);
+  /**
+   * Cancel pending retry, if any, and forget the destination
+   * \param dst the destination IP address
+   */
+  void Cancel (Ipv4Address dst);
+  /**
+   * \param dst the destination IP address
+   * \returns true if a retry for the destination is pending
+   */
+  bool IsRunning (Ipv4Address dst) const;
+  /**
+   * \returns the number of destinations with a known retry timer
+   */
+  uint32_t GetSize () const
+  {
+    return m_retries.size ();
+  }
+
+private:
+  /// Timer service
+  TimerService & m_timers;
+  /// Retry timer of each destination
+  std::unordered_map<Ipv4Address, TimerService::Handle, Ipv4AddressHash> m_retries;
+};
+
+}  // namespace aodv
+}  // namespace ns3
+
+#endif /* AODV_TIMER_SERVICE_H */
@@ -0,0 +1,68 @@
+
+#include "experimental-finite-state-machine.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+
+namespace ns3 {
+
+  NS_LOG_COMPONENT_DEFINE ("ExperimentalFiniteStateMachine");
+
+  ExperimentalFiniteStateMachine::ExperimentalFiniteStateMachine ()
+  {
+  }
+
+  void ExperimentalFiniteStateMachine::Watch (Ipv4Address suspect, uint32_t tolerance, Time listTimeout)
+  {
+    this->suspect = suspect;
+    this->tolerance = tolerance;
+    this->listTimeout = listTimeout;
+    this->spotted = 0;
+    this->isWatching = true;
+    this->isSuspectListed = false;
+  }
+
+  void ExperimentalFiniteStateMachine::Blacklist (Ipv4Address ipv4Address, Time timeout)
+  {
+    this->blackList[ipv4Address.Get ()] = timeout.IsZero () ? timeout : Simulator::Now () + timeout;
+  }
+
+  bool ExperimentalFiniteStateMachine::IsNextHopLegal (Ipv4Address ipv4Address)
+  {
+    if (!this->blackList.empty ())
+      {
+        std::unordered_map<uint32_t, Time>::iterator entry = this->blackList.find (ipv4Address.Get ());
+        if (entry != this->blackList.end ())
+          {
+            if (entry->second.IsZero () || Simulator::Now () < entry->second)
+              {
+                return false;
+              }
+            // Listing expired, the address has to be spotted again
+            this->blackList.erase (entry);
+            if (ipv4Address == this->suspect)
+              {
+                this->isSuspectListed = false;
+                this->spotted = 0;
+              }
+            NS_LOG_DEBUG ("FSM removed " << ipv4Address << " from blacklist");
+          }
+      }
+
+      if (this->isWatching && !this->isSuspectListed && ipv4Address == this->suspect)
+      {
+        NS_LOG_LOGIC ("FSM spotted " << this->suspect << " (not in black list)");
+        if (this->spotted >= this->tolerance) {
+          Blacklist (this->suspect, this->listTimeout);
+          this->isSuspectListed = true;
+          NS_LOG_DEBUG ("FSM added " << this->suspect << " to blacklist");
+        }
+        else {
+            this->spotted++;
+          NS_LOG_LOGIC ("FSM didn't add " << this->suspect << " to blacklist");
+          }
+      }
+
+    return true;
+  }
+}
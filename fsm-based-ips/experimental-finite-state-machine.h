@@ -0,0 +1,41 @@
+
+#ifndef NS_3_29_EXPERIMENTAL_FINITE_STATE_MACHINE_H
+#define NS_3_29_EXPERIMENTAL_FINITE_STATE_MACHINE_H
+
+#include <unordered_map>
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+
+
+namespace ns3 {
+
+class ExperimentalFiniteStateMachine {
+
+public:
+    ExperimentalFiniteStateMachine();
+
+    // Blacklist suspect for listTimeout (0 - forever) once it has been spotted as next hop more than tolerance times
+    void Watch(Ipv4Address suspect, uint32_t tolerance, Time listTimeout = Seconds (0));
+
+    // Blacklist address for timeout (0 - forever)
+    void Blacklist(Ipv4Address ipv4Address, Time timeout);
+
+    bool IsNextHopLegal(Ipv4Address ipv4Address);
+
+private:
+    // Expiry time of blacklisted addresses keyed by Ipv4Address::Get (), 0 - never expires
+    std::unordered_map<uint32_t, Time> blackList;
+    // Until Watch is called, 10.0.0.2 is blacklisted on its third sighting, as in the original FSM
+    Ipv4Address suspect = Ipv4Address ("10.0.0.2");
+    uint32_t tolerance = 2;
+    uint32_t spotted = 0;
+    Time listTimeout;
+    bool isWatching = true;
+    bool isSuspectListed = false;
+};
+
+
+}
+
+
+#endif //NS_3_29_EXPERIMENTAL_FINITE_STATE_MACHINE_H
@@ -37,6 +37,7 @@ void Fsm::ProcessHello ()
     if (this->m_helloPacketsInCurrentPeriod > this->m_helloFloodMaxInPeriod) {
         this->m_currentState = FSM_ALERT;
         std::cout << "Alert " << this->m_neighborIp << std::endl;
+        Fsms::Block(this->m_neighborIp);
     }
   }
 }
@@ -47,23 +48,26 @@ bool Fsm::IsMalicious ()
 }
 
 Fsm& Fsms::Create(Ipv4Address neighborIp) {
-  Fsms::m_fsms.push_back(
-      Fsm( Seconds(1), 10, neighborIp )
-  );
-  return Fsms::m_fsms.back();
+  return Fsms::m_fsms.insert(
+      std::make_pair(neighborIp, Fsm( Seconds(1), 10, neighborIp ))
+  ).first->second;
 }
 
 Fsm& Fsms::Get(Ipv4Address neighborIp) {
-  for (auto& fsm : Fsms::m_fsms) {
-    if (fsm.m_neighborIp == neighborIp) {
-        return fsm;
-      }
+  auto fsm = Fsms::m_fsms.find(neighborIp);
+  if (fsm != Fsms::m_fsms.end()) {
+    return fsm->second;
   }
 
   return Fsms::Create(neighborIp);
 }
 
-std::vector<Fsm> Fsms::m_fsms = std::vector<Fsm>();
+void Fsms::Block(Ipv4Address ip) {
+  Fsms::m_blocked.insert(ip);
+}
+
+std::unordered_map<Ipv4Address, Fsm, Ipv4AddressHash> Fsms::m_fsms = std::unordered_map<Ipv4Address, Fsm, Ipv4AddressHash>();
+std::unordered_set<Ipv4Address, Ipv4AddressHash> Fsms::m_blocked = std::unordered_set<Ipv4Address, Ipv4AddressHash>();
 
 } //namespace aodv
 
@@ -9,7 +9,8 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
 
-#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace ns3 {
 namespace aodv {
@@ -55,11 +56,27 @@ private:
 class Fsms {
 public:
   static Fsm& Get(Ipv4Address neighborIp);
+  // Checked before anything else on data packets; does not create an Fsm for unknown sources.
+  static bool IsBlocked(Ipv4Address ip) {
+    return !m_blocked.empty() && m_blocked.find(ip) != m_blocked.end();
+  }
+  // Called by Fsm on alert.
+  static void Block(Ipv4Address ip);
+  // Number of tracked neighbors, each one holds an Fsm.
+  static uint32_t GetSize() {
+    return m_fsms.size();
+  }
+  // Number of blocked neighbors.
+  static uint32_t GetBlockedSize() {
+    return m_blocked.size();
+  }
 
-  static std::vector<Fsm> m_fsms;
+  static std::unordered_map<Ipv4Address, Fsm, Ipv4AddressHash> m_fsms;
 
 private:
   static Fsm& Create(Ipv4Address neighborIp);
+
+  static std::unordered_set<Ipv4Address, Ipv4AddressHash> m_blocked;
 };
 
 }
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <cmath>
+#include "ns3/aodv-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/v4ping-helper.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvAllPairsPing");
+
+static uint64_t g_replies = 0;
+
+void CountRtt(Time rtt) {
+  g_replies++;
+}
+
+int main(int argc, char** argv) {
+  uint32_t gridWidth = 7;
+  double spacing = 100;
+  double duration = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("gridWidth", "Number of nodes in a grid row (grid is gridWidth x gridWidth)", gridWidth);
+  cmd.AddValue ("spacing", "Distance between grid neighbors, m", spacing);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.Parse (argc, argv);
+
+  SeedManager::SetSeed(12345);
+
+  uint32_t nodesQuantity = gridWidth * gridWidth;
+  NodeContainer nodes;
+  nodes.Create (nodesQuantity);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue(gridWidth),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  AodvHelper aodv;
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  // Every node pings every other node; all route discoveries start at once
+  ApplicationContainer apps;
+  for (uint32_t i = 0; i < nodesQuantity; ++i) {
+    for (uint32_t j = 0; j < nodesQuantity; ++j) {
+      if (i == j) {
+        continue;
+      }
+      V4PingHelper ping (interfaces.GetAddress (j));
+      apps.Add (ping.Install (nodes.Get (i)));
+    }
+  }
+  for (ApplicationContainer::Iterator i = apps.Begin (); i != apps.End (); ++i) {
+    (*i)->TraceConnectWithoutContext ("Rtt", MakeCallback (&CountRtt));
+  }
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (duration));
+
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+
+  std::cout << "Nodes: " << nodesQuantity << ", flows: " << apps.GetN () << "\n";
+  std::cout << "Echo replies: " << g_replies << "\n";
+  std::cout << "Wall clock: " << elapsedMs << " ms\n";
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <cmath>
+#include "ns3/aodv-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvBroadcastStorm");
+
+static uint64_t g_received = 0;
+
+void CountRx(Ptr<const Packet> packet, const Address &from) {
+  g_received++;
+}
+
+int main(int argc, char** argv) {
+  uint32_t gridWidth = 10;
+  double spacing = 50;
+  bool prefilter = true;
+  double falsePositiveRate = 0.01;
+  uint32_t prefilterCapacity = 4096;
+  double duration = 10;
+  std::string rate = "64kbps";
+
+  CommandLine cmd;
+  cmd.AddValue ("gridWidth", "Number of nodes in a grid row (grid is gridWidth x gridWidth)", gridWidth);
+  cmd.AddValue ("spacing", "Distance between grid neighbors, m", spacing);
+  cmd.AddValue ("prefilter", "Use Bloom prefilter for broadcast duplicate detection", prefilter);
+  cmd.AddValue ("fpRate", "Target false positive rate of the prefilter", falsePositiveRate);
+  cmd.AddValue ("capacity", "Expected number of live duplicate detection records", prefilterCapacity);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.AddValue ("rate", "Broadcast source data rate", rate);
+  cmd.Parse (argc, argv);
+
+  SeedManager::SetSeed(12345);
+
+  uint32_t nodesQuantity = gridWidth * gridWidth;
+  NodeContainer nodes;
+  nodes.Create (nodesQuantity);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue(gridWidth),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  AodvHelper aodv;
+  aodv.Set ("EnableDpdPrefilter", BooleanValue (prefilter));
+  aodv.Set ("DpdPrefilterFalsePositiveRate", DoubleValue (falsePositiveRate));
+  aodv.Set ("DpdPrefilterCapacity", UintegerValue (prefilterCapacity));
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  ApplicationContainer sinks = sink.Install (nodes);
+  sinks.Start (Seconds (0.0));
+  for (ApplicationContainer::Iterator i = sinks.Begin (); i != sinks.End (); ++i) {
+    (*i)->TraceConnectWithoutContext ("Rx", MakeCallback (&CountRx));
+  }
+
+  OnOffHelper source ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address ("10.255.255.255"), 9));
+  source.SetConstantRate (DataRate (rate), 512);
+  ApplicationContainer app = source.Install (nodes.Get (0));
+  app.Start (Seconds (2.0));
+  app.Stop (Seconds (duration));
+
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+
+  uint64_t negatives = 0;
+  uint64_t positives = 0;
+  uint64_t falsePositives = 0;
+  for (uint32_t i = 0; i < nodesQuantity; ++i) {
+    Ptr<aodv::RoutingProtocol> routing = nodes.Get (i)->GetObject<aodv::RoutingProtocol> ();
+    negatives += routing->GetDpdPrefilter ().GetFilterNegatives ();
+    positives += routing->GetDpdPrefilter ().GetFilterPositives ();
+    falsePositives += routing->GetDpdPrefilter ().GetFalsePositives ();
+  }
+
+  std::cout << "Nodes: " << nodesQuantity << ", prefilter: " << (prefilter ? "on" : "off") << "\n";
+  std::cout << "Broadcast packets delivered: " << g_received << "\n";
+  std::cout << "Wall clock: " << elapsedMs << " ms, "
+            << (elapsedMs > 0 ? g_received * 1000.0 / elapsedMs : 0) << " deliveries/s\n";
+  if (prefilter) {
+    std::cout << "Prefilter negatives: " << negatives << ", positives: " << positives
+              << ", false positives: " << falsePositives << "\n";
+  }
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include "ns3/aodv-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/v4ping-helper.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvLocalRepairLine");
+
+static uint64_t g_replies = 0;
+static Time g_lastReply = Seconds (0);
+static Time g_breakTime = Seconds (0);
+static Time g_recovery = Seconds (0);
+
+void CountRtt(Time rtt) {
+  Time now = Simulator::Now ();
+  g_replies++;
+  // First reply after the break ends the outage
+  if (g_recovery.IsZero () && g_lastReply < g_breakTime && now >= g_breakTime) {
+    g_recovery = now - g_breakTime;
+  }
+  g_lastReply = now;
+}
+
+void MoveAway(Ptr<Node> node) {
+  Ptr<MobilityModel> mob = node->GetObject<MobilityModel>();
+  Vector position = mob->GetPosition();
+  position.y += 1000;
+  mob->SetPosition(position);
+}
+
+int main(int argc, char** argv) {
+  uint32_t lineLength = 8;
+  double spacing = 100;
+  double detour = 50;
+  double breakAt = 10;
+  double duration = 30;
+  double interval = 0.1;
+  bool localRepair = true;
+  bool seedRoutes = false;
+  double range = 150;
+
+  CommandLine cmd;
+  cmd.AddValue ("lineLength", "Number of nodes in the line", lineLength);
+  cmd.AddValue ("spacing", "Distance between line neighbors, m", spacing);
+  cmd.AddValue ("detour", "Offset of the spare node from the middle node, m", detour);
+  cmd.AddValue ("breakAt", "Time the middle node leaves the line, s", breakAt);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.AddValue ("interval", "Ping interval, s", interval);
+  cmd.AddValue ("localRepair", "Repair broken routes locally", localRepair);
+  cmd.AddValue ("seedRoutes", "Pre-seed the ping route instead of discovering it", seedRoutes);
+  cmd.AddValue ("range", "Radio range assumed when seeding routes, m", range);
+  cmd.Parse (argc, argv);
+
+  SeedManager::SetSeed(12345);
+  g_breakTime = Seconds (breakAt);
+
+  NodeContainer nodes;
+  nodes.Create (lineLength);
+  // Spare node next to the middle of the line, used by the repaired route
+  NodeContainer spare;
+  spare.Create (1);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (0),
+                                 "GridWidth", UintegerValue(1000),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  mobility.Install (spare);
+
+  uint32_t middle = lineLength / 2;
+  spare.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (middle * spacing, detour, 0));
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  NetDeviceContainer spareDevice = wifi.Install (wifiPhy, wifiMac, spare);
+
+  AodvHelper aodv;
+  aodv.Set ("EnableLocalRepair", BooleanValue (localRepair));
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+  stack.Install (spare);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  address.Assign (spareDevice);
+
+  if (seedRoutes) {
+    std::vector<AodvHelper::Flow> flows;
+    flows.push_back (AodvHelper::Flow (0, lineLength - 1));
+    aodv.SeedRoutes (nodes, flows, range, Seconds (breakAt));
+  }
+
+  V4PingHelper ping (interfaces.GetAddress (lineLength - 1));
+  ping.SetAttribute ("Interval", TimeValue (Seconds (interval)));
+  ApplicationContainer app = ping.Install (nodes.Get (0));
+  app.Get (0)->TraceConnectWithoutContext ("Rtt", MakeCallback (&CountRtt));
+  app.Start (Seconds (2.0));
+  app.Stop (Seconds (duration));
+
+  Simulator::Schedule (Seconds (breakAt), &MoveAway, nodes.Get (middle));
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+
+  uint64_t sent = std::max (0.0, std::ceil ((duration - 2.0) / interval));
+  std::cout << "Local repair: " << (localRepair ? "on" : "off") << "\n";
+  std::cout << "Echo replies: " << g_replies << " of " << sent << "\n";
+  std::cout << "Delivery ratio: " << (sent > 0 ? double (g_replies) / sent : 0) << "\n";
+  if (g_recovery.IsZero ()) {
+    std::cout << "Route did not recover\n";
+  } else {
+    std::cout << "Recovery latency: " << g_recovery.GetSeconds () << " s\n";
+  }
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include "ns3/aodv-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/v4ping-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/energy-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvRreqFlood");
+
+static uint64_t g_replies = 0;
+
+void CountRtt(Time rtt) {
+  g_replies++;
+}
+
+// Prints state of the honest nodes: totals and the largest per node value
+void Sample(NodeContainer nodes, Time interval) {
+  uint64_t idCache = 0, routes = 0, queued = 0;
+  uint32_t maxIdCache = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i) {
+    Ptr<aodv::RoutingProtocol> aodv = nodes.Get (i)->GetObject<aodv::RoutingProtocol> ();
+    uint32_t size = aodv->GetRreqIdCacheSize ();
+    idCache += size;
+    maxIdCache = std::max (maxIdCache, size);
+    routes += aodv->GetRoutingTableSize ();
+    queued += aodv->GetQueueSize ();
+  }
+  std::cout << Simulator::Now ().GetSeconds () << "\t" << idCache << "\t" << maxIdCache
+            << "\t" << routes << "\t" << queued << "\n";
+  Simulator::Schedule (interval, &Sample, nodes, interval);
+}
+
+int main(int argc, char** argv) {
+  uint32_t gridWidth = 5;
+  double spacing = 100;
+  double rate = 100;
+  double attackStart = 5;
+  double duration = 30;
+  double sampleInterval = 1;
+  bool attack = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("gridWidth", "Number of honest nodes in a grid row (grid is gridWidth x gridWidth)", gridWidth);
+  cmd.AddValue ("spacing", "Distance between grid neighbors, m", spacing);
+  cmd.AddValue ("rate", "Flooded RREQs per second", rate);
+  cmd.AddValue ("attackStart", "Time the flood starts, s", attackStart);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.AddValue ("sampleInterval", "Interval between state samples, s", sampleInterval);
+  cmd.AddValue ("attack", "Run the RREQ flood, false for a baseline", attack);
+  cmd.Parse (argc, argv);
+
+  SeedManager::SetSeed(12345);
+
+  uint32_t nodesQuantity = gridWidth * gridWidth;
+  NodeContainer nodes;
+  nodes.Create (nodesQuantity);
+  NodeContainer attacker;
+  attacker.Create (1);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (spacing),
+                                 "DeltaY", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue(gridWidth),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  mobility.Install (attacker);
+  // Attacker next to the middle of the grid
+  double middle = (gridWidth / 2) * spacing;
+  attacker.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (middle + spacing / 2, middle, 0));
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  NetDeviceContainer attackerDevice = wifi.Install (wifiPhy, wifiMac, attacker);
+
+  AodvHelper aodv;
+
+  std::ostringstream behavior;
+  behavior << "ns3::aodv::RreqFloodAttack[Interval=" << 1000.0 / rate << "ms]";
+  AodvHelper aodvFlood;
+  if (attack) {
+    aodvFlood.Set ("AttackBehavior", StringValue (behavior.str ()));
+    aodvFlood.Set ("AttackStart", TimeValue (Seconds (attackStart)));
+    // Skip the expanding ring search, every RREQ goes network wide
+    aodvFlood.Set ("TtlStart", UintegerValue (35));
+  }
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+
+  InternetStackHelper attackerStack;
+  attackerStack.SetRoutingHelper (aodvFlood);
+  attackerStack.Install (attacker);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  address.Assign (attackerDevice);
+
+  // AODV routing protocol energy model of every honest node
+  BasicEnergySourceHelper basicSourceHelper;
+  basicSourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (1000000));
+  EnergySourceContainer sources = basicSourceHelper.Install (nodes);
+  AodvEnergyModelHelper aodvEnergyHelper;
+  DeviceEnergyModelContainer deviceModels = aodvEnergyHelper.Install (devices, sources);
+
+  // Corner to corner ping, its delivery shows the effect of the flood on legitimate traffic
+  V4PingHelper ping (interfaces.GetAddress (nodesQuantity - 1));
+  ping.SetAttribute ("Interval", TimeValue (Seconds (0.5)));
+  ApplicationContainer app = ping.Install (nodes.Get (0));
+  app.Get (0)->TraceConnectWithoutContext ("Rtt", MakeCallback (&CountRtt));
+  app.Start (Seconds (2.0));
+  app.Stop (Seconds (duration));
+
+  std::cout << "time\tidCache\tmaxIdCache\troutes\tqueued\n";
+  Simulator::Schedule (Seconds (sampleInterval), &Sample, nodes, Seconds (sampleInterval));
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+
+  uint64_t sent = std::max (0.0, std::ceil ((duration - 2.0) / 0.5));
+  std::cout << "RREQ flood: " << (attack ? "on" : "off") << "\n";
+  std::cout << "Echo replies: " << g_replies << " of " << sent << "\n";
+
+  double total = 0;
+  double maxEnergy = 0;
+  for (DeviceEnergyModelContainer::Iterator iter = deviceModels.Begin (); iter != deviceModels.End (); iter ++) {
+    double energyConsumed = (*iter)->GetTotalEnergyConsumption ();
+    total += energyConsumed;
+    maxEnergy = std::max (maxEnergy, energyConsumed);
+  }
+  std::cout << "AODV energy of honest nodes, total: " << total << " J, mean: " << total / nodesQuantity
+            << " J, max: " << maxEnergy << " J\n";
+
+  Simulator::Destroy ();
+
+  return 0;
+}
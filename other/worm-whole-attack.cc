@@ -6,7 +6,6 @@
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/mobility-module.h"
-#include "ns3/point-to-point-module.h"
 #include "ns3/v4ping-helper.h"
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/energy-module.h"
@@ -16,6 +15,12 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("AodvWormWholeAttack");
 
+static uint64_t g_replies = 0;
+
+void CountRtt(Time rtt) {
+    g_replies++;
+}
+
 void PrintNodePosition(ns3::Ptr<ns3::Node> ptr_node, int node_id) {
     Ptr<MobilityModel> mob = ptr_node->GetObject<MobilityModel>();
     double x = mob->GetPosition().x;
@@ -26,6 +31,18 @@ void PrintNodePosition(ns3::Ptr<ns3::Node> ptr_node, int node_id) {
 
 int main(int argc, char** argv) {
     uint32_t nodesInGroup = 5;
+    double gap = 250;
+    double latency = 1;
+    double duration = 10;
+    bool wormhole = true;
+
+    CommandLine cmd;
+    cmd.AddValue ("nodesInGroup", "Number of nodes in each group", nodesInGroup);
+    cmd.AddValue ("gap", "Distance between the first rows of the groups, m", gap);
+    cmd.AddValue ("latency", "Delay of the wormhole tunnel, ms", latency);
+    cmd.AddValue ("duration", "Simulation time, s", duration);
+    cmd.AddValue ("wormhole", "Join the groups with a wormhole", wormhole);
+    cmd.Parse (argc, argv);
 
     NodeContainer nodesGroup1;
     NodeContainer nodesGroup2;
@@ -53,7 +70,7 @@ int main(int argc, char** argv) {
     MobilityHelper mobility2;
     mobility2.SetPositionAllocator ("ns3::GridPositionAllocator",
                                    "MinX", DoubleValue (0.0),
-                                   "MinY", DoubleValue (250.0),
+                                   "MinY", DoubleValue (gap),
                                    "DeltaX", DoubleValue (50),
                                    "DeltaY", DoubleValue (50),
                                    "GridWidth", UintegerValue(2),
@@ -102,27 +119,36 @@ int main(int argc, char** argv) {
     nodesGroup1Interfaces = address.Assign (nodesGroup1Devices);
     nodesGroup2Interfaces = address.Assign (nodesGroup2Devices);
 
-    NodeContainer p2pNodes;
-    p2pNodes.Add(nodesGroup1.Get(nodesInGroup - 1));
-    p2pNodes.Add(nodesGroup2.Get(0));
-
-    PointToPointHelper pointToPoint;
-    pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
-    pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+    // The last node of group 1 and the first node of group 2 collude
+    Ptr<aodv::RoutingProtocol> end1 = nodesGroup1.Get(nodesInGroup - 1)->GetObject<aodv::RoutingProtocol>();
+    Ptr<aodv::RoutingProtocol> end2 = nodesGroup2.Get(0)->GetObject<aodv::RoutingProtocol>();
+    if (wormhole) {
+        aodv::WormholeAttack::Connect(end1, end2);
+        end1->GetAttackBehavior()->SetAttribute("Latency", TimeValue(MilliSeconds(latency)));
+        end2->GetAttackBehavior()->SetAttribute("Latency", TimeValue(MilliSeconds(latency)));
+    }
 
-    NetDeviceContainer p2pDevices;
-    p2pDevices = pointToPoint.Install (p2pNodes);
+    V4PingHelper ping (nodesGroup2Interfaces.GetAddress (nodesInGroup - 1));
+    ApplicationContainer app = ping.Install (nodesGroup1.Get (0));
+    app.Get (0)->TraceConnectWithoutContext ("Rtt", MakeCallback (&CountRtt));
+    app.Start (Seconds (2.0));
+    app.Stop (Seconds (duration));
 
-    address.SetBase("10.0.2.0", "255.255.255.0");
-    Ipv4InterfaceContainer p2pInterfaces;
-    p2pInterfaces = address.Assign (p2pDevices);
+    Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> ("aodv.routes", std::ios::out);
+    aodv.PrintRoutingTableAllAt (Seconds (duration - 2), routingStream);
 
-    //pointToPoint.EnablePcapAll ("second");
+    Simulator::Stop (Seconds (duration));
+    Simulator::Run ();
 
-    Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> ("my_data/aodv.routes", std::ios::out);
-    aodv.PrintRoutingTableAllAt (Seconds (8), routingStream);
+    std::cout << "\nEcho replies: " << g_replies << "\n";
+    if (wormhole) {
+        Ptr<aodv::WormholeAttack> tunnel1 = DynamicCast<aodv::WormholeAttack>(end1->GetAttackBehavior());
+        Ptr<aodv::WormholeAttack> tunnel2 = DynamicCast<aodv::WormholeAttack>(end2->GetAttackBehavior());
+        std::cout << "Tunneled control packets: " << tunnel1->GetTunneledControl() + tunnel2->GetTunneledControl() << "\n";
+        std::cout << "Tunneled data packets: " << tunnel1->GetTunneledData() + tunnel2->GetTunneledData() << "\n";
+    }
 
-    Simulator::Stop (Seconds (10));
-    Simulator::Run ();
+    Simulator::Destroy ();
 
-}
\ No newline at end of file
+    return 0;
+}
@@ -0,0 +1,376 @@
+// Parameterized AODV attack and defense scenario.
+//
+// Every parameter is set with --name=value or in a config file given with --config=<file>,
+// one "name = value" per line, '#' starts a comment. Command line values override the file.
+// Attribute defaults can be set the same way, e.g. "ns3::aodv::RoutingProtocol::HelloInterval = 2s".
+// Prints parameters, then results as "name=value" lines after "# results".
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include "ns3/aodv-module.h"
+#include "ns3/fsm.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/v4ping-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/energy-module.h"
+#include "ns3/wifi-radio-energy-model-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("AodvScenario");
+
+static uint64_t g_replies = 0;
+static Time g_rttSum = Seconds (0);
+
+void CountRtt(Time rtt) {
+  g_replies++;
+  g_rttSum += rtt;
+}
+
+// Reads "name = value" lines of a config file as "--name=value" arguments
+std::vector<std::string> ReadConfig(std::string const & path) {
+  std::vector<std::string> args;
+  std::ifstream file (path.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Cannot open config file " << path);
+  std::string line;
+  while (std::getline (file, line)) {
+    line = line.substr (0, line.find ('#'));
+    std::string::size_type eq = line.find ('=');
+    if (eq == std::string::npos) {
+      NS_ABORT_MSG_UNLESS (line.find_first_not_of (" \t\r") == std::string::npos, "Bad config line: " << line);
+      continue;
+    }
+    std::string name = line.substr (0, eq);
+    std::string value = line.substr (eq + 1);
+    name.erase (0, name.find_first_not_of (" \t"));
+    name.erase (name.find_last_not_of (" \t\r") + 1);
+    value.erase (0, value.find_first_not_of (" \t"));
+    value.erase (value.find_last_not_of (" \t\r") + 1);
+    args.push_back ("--" + name + "=" + value);
+  }
+  return args;
+}
+
+// Behavior of the attack, with extra attacker attributes appended to aodv
+std::string SetUpAttack(std::string const & attack, AodvHelper & aodv) {
+  if (attack == "blackhole") {
+    return "ns3::aodv::BlackHoleAttack";
+  } else if (attack == "grayhole") {
+    return "ns3::aodv::GrayHoleAttack";
+  } else if (attack == "helloflood") {
+    aodv.Set ("EnableHello", BooleanValue (true));
+    return "ns3::aodv::HelloFloodAttack";
+  } else if (attack == "sybil") {
+    aodv.Set ("EnableHello", BooleanValue (true));
+    return "ns3::aodv::SybilHelloFloodAttack";
+  } else if (attack == "rreqflood") {
+    // Skip the expanding ring search, every RREQ goes network wide
+    aodv.Set ("TtlStart", UintegerValue (35));
+    return "ns3::aodv::RreqFloodAttack";
+  } else if (attack == "wormhole") {
+    return "ns3::aodv::WormholeAttack";
+  } else if (attack == "redirection") {
+    return "ns3::aodv::TrafficRedirection";
+  }
+  NS_ABORT_MSG ("Unknown attack " << attack);
+  return "";
+}
+
+int main(int argc, char** argv) {
+  std::string config;
+  uint32_t nodesQuantity = 25;
+  std::string topology = "grid";
+  double spacing = 100;
+  uint32_t gridWidth = 0;
+  double gap = 250;
+  double area = 500;
+  std::string attack = "none";
+  std::string behavior;
+  uint32_t attackers = 1;
+  std::string placement = "center";
+  double attackStart = 0;
+  double attackStop = 0;
+  bool helloFloodPrevention = false;
+  bool dpdPrefilter = false;
+  bool localRepair = false;
+  bool multipath = false;
+  std::string energy = "none";
+  double initialEnergy = 1000000;
+  uint32_t flows = 1;
+  double pingInterval = 1;
+  double trafficStart = 2;
+  double duration = 30;
+  uint32_t seed = 12345;
+  uint32_t run = 1;
+  bool pcap = false;
+  std::string routes;
+
+  CommandLine cmd;
+  cmd.AddValue ("config", "File with \"name = value\" lines for any of these parameters", config);
+  cmd.AddValue ("nodes", "Number of honest nodes", nodesQuantity);
+  cmd.AddValue ("topology", "Placement of honest nodes: grid, line, groups (two grids \"gap\" apart) or random", topology);
+  cmd.AddValue ("spacing", "Distance between grid or line neighbors, m", spacing);
+  cmd.AddValue ("gridWidth", "Nodes in a grid row, 0 for a square grid", gridWidth);
+  cmd.AddValue ("gap", "Distance between the first rows of the two groups, m", gap);
+  cmd.AddValue ("area", "Side of the square random nodes are placed in, m", area);
+  cmd.AddValue ("attack", "none, blackhole, grayhole, helloflood, sybil, rreqflood, wormhole or redirection", attack);
+  cmd.AddValue ("behavior", "Attack behavior with attributes, e.g. ns3::aodv::GrayHoleAttack[DropProbability=0.8]; overrides the default behavior of the attack", behavior);
+  cmd.AddValue ("attackers", "Number of attacker nodes, a wormhole always has 2", attackers);
+  cmd.AddValue ("placement", "Placement of attackers: center, edge (alternating just outside opposite corners) or random", placement);
+  cmd.AddValue ("attackStart", "Time the attack is switched on, s", attackStart);
+  cmd.AddValue ("attackStop", "Time the attack is switched off, s, 0 keeps it on", attackStop);
+  cmd.AddValue ("helloFloodPrevention", "Enable hello flood prevention on honest nodes", helloFloodPrevention);
+  cmd.AddValue ("dpdPrefilter", "Enable broadcast duplicate detection prefilter on honest nodes", dpdPrefilter);
+  cmd.AddValue ("localRepair", "Enable local repair on honest nodes", localRepair);
+  cmd.AddValue ("multipath", "Keep alternate paths on honest nodes", multipath);
+  cmd.AddValue ("energy", "Energy model: none, aodv (routing protocol) or radio (wifi radio)", energy);
+  cmd.AddValue ("initialEnergy", "Initial energy of every node, J", initialEnergy);
+  cmd.AddValue ("flows", "Number of ping flows between random pairs of honest nodes", flows);
+  cmd.AddValue ("pingInterval", "Ping interval, s", pingInterval);
+  cmd.AddValue ("trafficStart", "Time pings start, s", trafficStart);
+  cmd.AddValue ("duration", "Simulation time, s", duration);
+  cmd.AddValue ("seed", "Random seed", seed);
+  cmd.AddValue ("run", "Random run number", run);
+  cmd.AddValue ("pcap", "Write pcap traces", pcap);
+  cmd.AddValue ("routes", "File to print all routing tables to at the end, empty for none", routes);
+
+  // Config file first, so the command line overrides it
+  std::vector<std::string> args;
+  args.push_back (argv[0]);
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare (0, 9, "--config=") == 0) {
+      std::vector<std::string> fileArgs = ReadConfig (arg.substr (9));
+      args.insert (args.begin () + 1, fileArgs.begin (), fileArgs.end ());
+    }
+  }
+  for (int i = 1; i < argc; ++i) {
+    args.push_back (argv[i]);
+  }
+  std::vector<char *> argp;
+  for (uint32_t i = 0; i < args.size (); ++i) {
+    argp.push_back (&args[i][0]);
+  }
+  cmd.Parse (argp.size (), argp.data ());
+
+  NS_ABORT_MSG_UNLESS (nodesQuantity > 0, "At least one honest node is needed");
+  SeedManager::SetSeed (seed);
+  SeedManager::SetRun (run);
+
+  if (attack == "wormhole") {
+    attackers = 2;
+  } else if (attack == "none") {
+    attackers = 0;
+  }
+
+  NodeContainer nodes;
+  nodes.Create (nodesQuantity);
+  NodeContainer attackerNodes;
+  attackerNodes.Create (attackers);
+
+  MobilityHelper mobility;
+  if (topology == "grid" || topology == "line") {
+    if (topology == "line") {
+      gridWidth = nodesQuantity;
+    } else if (gridWidth == 0) {
+      gridWidth = std::ceil (std::sqrt (nodesQuantity));
+    }
+    mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                   "MinX", DoubleValue (0.0),
+                                   "MinY", DoubleValue (0.0),
+                                   "DeltaX", DoubleValue (spacing),
+                                   "DeltaY", DoubleValue (spacing),
+                                   "GridWidth", UintegerValue(gridWidth),
+                                   "LayoutType", StringValue ("RowFirst"));
+  } else if (topology == "groups") {
+    // First half of the nodes in one grid, the rest in another one "gap" further on y
+    uint32_t inFirstGroup = (nodesQuantity + 1) / 2;
+    if (gridWidth == 0) {
+      gridWidth = std::ceil (std::sqrt (inFirstGroup));
+    }
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    for (uint32_t i = 0; i < nodesQuantity; ++i) {
+      uint32_t inGroup = i < inFirstGroup ? i : i - inFirstGroup;
+      positions->Add (Vector (spacing * (inGroup % gridWidth),
+                              spacing * (inGroup / gridWidth) + (i < inFirstGroup ? 0 : gap), 0));
+    }
+    mobility.SetPositionAllocator (positions);
+  } else if (topology == "random") {
+    std::ostringstream side;
+    side << "ns3::UniformRandomVariable[Min=0.0|Max=" << area << "]";
+    mobility.SetPositionAllocator ("ns3::RandomRectanglePositionAllocator",
+                                   "X", StringValue (side.str ()),
+                                   "Y", StringValue (side.str ()));
+  } else {
+    NS_ABORT_MSG ("Unknown topology " << topology);
+  }
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  mobility.Install (attackerNodes);
+
+  // Attackers are placed relative to the bounding box of the honest nodes
+  Vector low = nodes.Get (0)->GetObject<MobilityModel> ()->GetPosition ();
+  Vector high = low;
+  for (uint32_t i = 1; i < nodesQuantity; ++i) {
+    Vector position = nodes.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+    low.x = std::min (low.x, position.x);
+    low.y = std::min (low.y, position.y);
+    high.x = std::max (high.x, position.x);
+    high.y = std::max (high.y, position.y);
+  }
+  Ptr<UniformRandomVariable> placementRv = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < attackers; ++i) {
+    Vector position;
+    if (placement == "center") {
+      // Between the middle nodes, side by side if there are several attackers
+      position = Vector ((low.x + high.x) / 2 + spacing / 2 * i, (low.y + high.y) / 2 + spacing / 2, 0);
+    } else if (placement == "edge") {
+      // Just outside the corner, so that the attacker does not sit on the corner node
+      double outward = (i % 2 == 0 ? -1 : 1) * spacing / 2;
+      position = (i % 2 == 0) ? low : high;
+      position.x += outward;
+      position.y += outward;
+      position.x -= outward * (i / 2);
+    } else if (placement == "random") {
+      position = Vector (placementRv->GetValue (low.x, high.x), placementRv->GetValue (low.y, high.y), 0);
+    } else {
+      NS_ABORT_MSG ("Unknown placement " << placement);
+    }
+    attackerNodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (position);
+  }
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+  NetDeviceContainer attackerDevices = wifi.Install (wifiPhy, wifiMac, attackerNodes);
+  if (pcap) {
+    wifiPhy.EnablePcapAll (std::string ("aodv"));
+  }
+
+  AodvHelper aodv;
+  aodv.Set ("EnableHelloFloodPrevention", BooleanValue (helloFloodPrevention));
+  aodv.Set ("EnableDpdPrefilter", BooleanValue (dpdPrefilter));
+  aodv.Set ("EnableLocalRepair", BooleanValue (localRepair));
+  aodv.Set ("EnableMultipath", BooleanValue (multipath));
+
+  AodvHelper aodvAttacker;
+  if (attackers > 0) {
+    std::string attackBehavior = SetUpAttack (attack, aodvAttacker);
+    aodvAttacker.Set ("AttackBehavior", StringValue (behavior.empty () ? attackBehavior : behavior));
+    aodvAttacker.Set ("AttackStart", TimeValue (Seconds (attackStart)));
+    aodvAttacker.Set ("AttackStop", TimeValue (Seconds (attackStop)));
+  }
+
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (aodv);
+  stack.Install (nodes);
+
+  InternetStackHelper attackerStack;
+  attackerStack.SetRoutingHelper (aodvAttacker);
+  attackerStack.Install (attackerNodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  address.Assign (attackerDevices);
+
+  if (attack == "wormhole") {
+    aodv::WormholeAttack::Connect (attackerNodes.Get (0)->GetObject<aodv::RoutingProtocol> (),
+                                   attackerNodes.Get (1)->GetObject<aodv::RoutingProtocol> ());
+  }
+
+  DeviceEnergyModelContainer energyModels;
+  DeviceEnergyModelContainer attackerEnergyModels;
+  if (energy != "none") {
+    BasicEnergySourceHelper basicSourceHelper;
+    basicSourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (initialEnergy));
+    EnergySourceContainer sources = basicSourceHelper.Install (nodes);
+    EnergySourceContainer attackerSources = basicSourceHelper.Install (attackerNodes);
+    if (energy == "aodv") {
+      AodvEnergyModelHelper energyHelper;
+      energyModels = energyHelper.Install (devices, sources);
+      attackerEnergyModels = energyHelper.Install (attackerDevices, attackerSources);
+    } else if (energy == "radio") {
+      WifiRadioEnergyModelHelper energyHelper;
+      energyModels = energyHelper.Install (devices, sources);
+      attackerEnergyModels = energyHelper.Install (attackerDevices, attackerSources);
+    } else {
+      NS_ABORT_MSG ("Unknown energy model " << energy);
+    }
+  }
+
+  // A single flow goes corner to corner, more flows between random pairs
+  Ptr<UniformRandomVariable> flowRv = CreateObject<UniformRandomVariable> ();
+  ApplicationContainer apps;
+  for (uint32_t i = 0; i < flows && nodesQuantity > 1; ++i) {
+    uint32_t source = 0;
+    uint32_t destination = nodesQuantity - 1;
+    if (i > 0) {
+      source = flowRv->GetInteger (0, nodesQuantity - 1);
+      destination = (source + flowRv->GetInteger (1, nodesQuantity - 1)) % nodesQuantity;
+    }
+    V4PingHelper ping (interfaces.GetAddress (destination));
+    ping.SetAttribute ("Interval", TimeValue (Seconds (pingInterval)));
+    apps.Add (ping.Install (nodes.Get (source)));
+  }
+  for (ApplicationContainer::Iterator i = apps.Begin (); i != apps.End (); ++i) {
+    (*i)->TraceConnectWithoutContext ("Rtt", MakeCallback (&CountRtt));
+  }
+  apps.Start (Seconds (trafficStart));
+  apps.Stop (Seconds (duration));
+
+  if (!routes.empty ()) {
+    Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> (routes, std::ios::out);
+    aodv.PrintRoutingTableAllAt (Seconds (duration) - NanoSeconds (1), routingStream);
+  }
+
+  std::cout << "# parameters\n";
+  std::cout << "nodes=" << nodesQuantity << "\ntopology=" << topology << "\nattack=" << attack
+            << "\nattackers=" << attackers << "\nplacement=" << placement
+            << "\nhelloFloodPrevention=" << helloFloodPrevention << "\nenergy=" << energy
+            << "\nflows=" << apps.GetN () << "\nduration=" << duration << "\nseed=" << seed << "\nrun=" << run << "\n";
+
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsedMs = clock.End ();
+
+  uint64_t sent = apps.GetN () * std::max (0.0, std::ceil ((duration - trafficStart) / pingInterval));
+  std::cout << "# results\n";
+  std::cout << "pingsSent=" << sent << "\n";
+  std::cout << "pingReplies=" << g_replies << "\n";
+  std::cout << "deliveryRatio=" << (sent > 0 ? double (g_replies) / sent : 0) << "\n";
+  std::cout << "meanRtt=" << (g_replies > 0 ? g_rttSum.GetSeconds () / g_replies : 0) << "\n";
+  std::cout << "fsms=" << aodv::Fsms::GetSize () << "\n";
+  std::cout << "blocked=" << aodv::Fsms::GetBlockedSize () << "\n";
+  if (energy != "none") {
+    double honest = 0;
+    for (DeviceEnergyModelContainer::Iterator iter = energyModels.Begin (); iter != energyModels.End (); iter ++) {
+      honest += (*iter)->GetTotalEnergyConsumption ();
+    }
+    double malicious = 0;
+    for (DeviceEnergyModelContainer::Iterator iter = attackerEnergyModels.Begin (); iter != attackerEnergyModels.End (); iter ++) {
+      malicious += (*iter)->GetTotalEnergyConsumption ();
+    }
+    std::cout << "energyHonest=" << honest << "\n";
+    std::cout << "energyHonestMean=" << honest / nodesQuantity << "\n";
+    std::cout << "energyAttackers=" << malicious << "\n";
+  }
+  std::cout << "wallClockMs=" << elapsedMs << "\n";
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+"""Parallel parameter sweep over scenario-runner/aodv-scenario.cc.
+
+Every combination of the swept values is one run of the scenario program;
+runs are independent ns-3 processes fanned out over the local cores. Each
+finished run is appended to a JSON lines file at once, so an interrupted
+sweep resumes where it stopped when started again with the same output
+directory. At the end all runs are collected into results.csv.
+
+A sweep is given in a JSON file and/or with --set options:
+
+    {
+      "base": {"topology": "grid", "duration": 30, "energy": "aodv"},
+      "sweep": {
+        "nodes": [25, 49, 100],
+        "attack": ["none", "helloflood"],
+        "helloFloodPrevention": ["false", "true"]
+      },
+      "runs": 10
+    }
+
+"runs" varies the ns-3 run number (RngRun) of each combination from 1 to
+the given count with the seed left fixed, which gives independent
+replications. Parameters are passed to the program as --name=value, so
+ns-3 attribute defaults can be swept too.
+
+Example:
+
+    ./waf build
+    python3 scenario-runner/sweep.py --ns3-dir . --spec sweep.json \\
+        --set "behavior=ns3::aodv::HelloFloodAttack[Interval=1ms],ns3::aodv::HelloFloodAttack[Interval=10ms]" \\
+        --out sweeps/nightly
+"""
+
+import argparse
+import csv
+import hashlib
+import itertools
+import json
+import multiprocessing
+import os
+import subprocess
+import sys
+import time
+
+RESULTS_MARKER = "# results"
+
+
+def parse_set(options):
+    """--set name=v1,v2 options as a dict of value lists."""
+    sweep = {}
+    for option in options:
+        name, sep, values = option.partition("=")
+        if not sep:
+            raise SystemExit("--set needs name=value[,value...]: " + option)
+        # Values with attribute lists keep their commas inside brackets
+        sweep[name] = split_values(values)
+    return sweep
+
+
+def split_values(values):
+    parts, depth, current = [], 0, ""
+    for c in values:
+        if c == "[":
+            depth += 1
+        elif c == "]":
+            depth -= 1
+        if c == "," and depth == 0:
+            parts.append(current)
+            current = ""
+        else:
+            current += c
+    parts.append(current)
+    return parts
+
+
+def make_jobs(base, sweep, runs):
+    """All parameter combinations, each with a stable job id."""
+    names = sorted(sweep)
+    jobs = []
+    for values in itertools.product(*(sweep[name] for name in names)):
+        for run in range(1, runs + 1):
+            params = dict(base)
+            params.update(zip(names, values))
+            if runs > 1 or "run" not in params:
+                params["run"] = run
+            params = {name: str(value) for name, value in params.items()}
+            key = json.dumps(params, sort_keys=True)
+            job_id = hashlib.sha1(key.encode()).hexdigest()[:12]
+            jobs.append((job_id, params))
+    return jobs
+
+
+def load_done(path, retry_failed):
+    """Job ids already recorded in the results file."""
+    done = set()
+    if not os.path.exists(path):
+        return done
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                record = json.loads(line)
+            except ValueError:
+                # Line cut short by an interrupted sweep
+                continue
+            if record["status"] == "ok" or not retry_failed:
+                done.add(record["job_id"])
+    return done
+
+
+def parse_results(output):
+    results = {}
+    in_results = False
+    for line in output.splitlines():
+        if line.strip() == RESULTS_MARKER:
+            in_results = True
+        elif in_results and "=" in line:
+            name, _, value = line.partition("=")
+            results[name.strip()] = value.strip()
+    return results
+
+
+def run_job(job):
+    """Worker: run one scenario and return its record."""
+    job_id, params, program, env, timeout, log_dir = job
+    command = [program] + ["--%s=%s" % (name, value) for name, value in sorted(params.items())]
+    record = {"job_id": job_id, "params": params}
+    start = time.time()
+    try:
+        completed = subprocess.run(command, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                   universal_newlines=True, timeout=timeout)
+        output = completed.stdout
+        record["status"] = "ok" if completed.returncode == 0 else "failed"
+        record["returncode"] = completed.returncode
+    except subprocess.TimeoutExpired as e:
+        output = e.output or ""
+        if isinstance(output, bytes):
+            output = output.decode(errors="replace")
+        record["status"] = "timeout"
+    record["seconds"] = round(time.time() - start, 3)
+    record["results"] = parse_results(output)
+    if log_dir:
+        with open(os.path.join(log_dir, job_id + ".log"), "w") as f:
+            f.write(" ".join(command) + "\n" + output)
+    return record
+
+
+def write_table(records_path, table_path):
+    """Collect the JSON lines records into one CSV table, last record of a job wins."""
+    records = {}
+    with open(records_path) as f:
+        for line in f:
+            try:
+                record = json.loads(line)
+            except ValueError:
+                continue
+            records[record["job_id"]] = record
+    param_names = sorted({name for r in records.values() for name in r["params"]})
+    result_names = sorted({name for r in records.values() for name in r["results"]})
+    with open(table_path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["job_id", "status", "seconds"] + param_names + result_names)
+        for record in records.values():
+            writer.writerow([record["job_id"], record["status"], record["seconds"]]
+                            + [record["params"].get(name, "") for name in param_names]
+                            + [record["results"].get(name, "") for name in result_names])
+    return len(records)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--spec", help="JSON sweep file with base, sweep and runs")
+    parser.add_argument("--set", action="append", default=[], metavar="NAME=V1,V2",
+                        help="sweep a parameter over values, overrides the spec file")
+    parser.add_argument("--runs", type=int, help="replications of each combination, overrides the spec file")
+    parser.add_argument("--ns3-dir", default=".", help="ns-3 directory with the built scenario program")
+    parser.add_argument("--program", help="scenario program, default <ns3-dir>/build/scratch/aodv-scenario")
+    parser.add_argument("--out", default="sweep", help="output directory, reused to resume a sweep")
+    parser.add_argument("--jobs", type=int, default=multiprocessing.cpu_count(), help="parallel runs")
+    parser.add_argument("--timeout", type=float, help="seconds before a run is killed")
+    parser.add_argument("--retry-failed", action="store_true", help="run failed and timed out jobs again")
+    parser.add_argument("--logs", action="store_true", help="keep the output of every run in <out>/logs")
+    parser.add_argument("--dry-run", action="store_true", help="list pending runs without starting them")
+    args = parser.parse_args()
+
+    spec = {}
+    if args.spec:
+        with open(args.spec) as f:
+            spec = json.load(f)
+    base = spec.get("base", {})
+    sweep = {name: list(values) for name, values in spec.get("sweep", {}).items()}
+    sweep.update(parse_set(args.set))
+    runs = args.runs if args.runs is not None else spec.get("runs", 1)
+
+    program = os.path.abspath(args.program or os.path.join(args.ns3_dir, "build", "scratch", "aodv-scenario"))
+    if not args.dry_run and not os.access(program, os.X_OK):
+        raise SystemExit("Scenario program %s not found, build ns-3 first or give --program" % program)
+    env = dict(os.environ)
+    lib_dir = os.path.abspath(os.path.join(args.ns3_dir, "build", "lib"))
+    env["LD_LIBRARY_PATH"] = lib_dir + os.pathsep + env.get("LD_LIBRARY_PATH", "")
+
+    os.makedirs(args.out, exist_ok=True)
+    log_dir = None
+    if args.logs:
+        log_dir = os.path.join(args.out, "logs")
+        os.makedirs(log_dir, exist_ok=True)
+    records_path = os.path.join(args.out, "results.jsonl")
+    table_path = os.path.join(args.out, "results.csv")
+
+    jobs = make_jobs(base, sweep, runs)
+    done = load_done(records_path, args.retry_failed)
+    pending = [(job_id, params, program, env, args.timeout, log_dir)
+               for job_id, params in jobs if job_id not in done]
+    print("%d runs, %d done, %d pending, %d parallel" % (len(jobs), len(jobs) - len(pending), len(pending), args.jobs))
+    if args.dry_run:
+        for job in pending:
+            print(job[0], " ".join("--%s=%s" % item for item in sorted(job[1].items())))
+        return
+
+    failed = 0
+    started = time.time()
+    pool = multiprocessing.Pool(args.jobs)
+    try:
+        with open(records_path, "a") as records:
+            for i, record in enumerate(pool.imap_unordered(run_job, pending), 1):
+                records.write(json.dumps(record, sort_keys=True) + "\n")
+                records.flush()
+                if record["status"] != "ok":
+                    failed += 1
+                elapsed = time.time() - started
+                eta = elapsed / i * (len(pending) - i)
+                print("[%d/%d] %s %s in %.1fs, eta %.0fs" % (i, len(pending), record["job_id"], record["status"],
+                                                             record["seconds"], eta))
+        pool.close()
+    except KeyboardInterrupt:
+        pool.terminate()
+        print("Interrupted, run again with the same --out to resume")
+        raise SystemExit(1)
+    finally:
+        pool.join()
+        if os.path.exists(records_path):
+            count = write_table(records_path, table_path)
+            print("%d runs in %s" % (count, table_path))
+    if failed:
+        print("%d runs failed, see %s; --retry-failed runs them again" % (failed, records_path))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()